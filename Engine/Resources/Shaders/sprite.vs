@@ -1,12 +1,16 @@
-#version 460 core
+#version 450 core
 layout (location = 0) in vec2 position;
 layout (location = 1) in vec2 coords;
+layout (location = 2) in float slot;  // texture slot, 0 unless the renderer batches several textures
 
 out vec2 TexCoords;
+flat out int Slot;
 uniform mat4 projection;      // Screen coordinates to normalized
+uniform mat4 view;            // World to screen coordinates, identity for sprites already placed relative to the camera
 
 void main()
 {
     TexCoords = coords;
-    gl_Position = projection * vec4(position, 0.0, 1.0);
+    Slot = int(slot);
+    gl_Position = projection * view * vec4(position, 0.0, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,25 @@
+#version 450 core
+in vec2 TexCoords;
+flat in int Slot;
+out vec4 color;
+
+uniform sampler2D images[8];   // one per texture slot, Renderer::MAX_TEXTURE_SLOTS
+
+void main()
+{
+    // Samplers can't be indexed by a per sprite value, so the slot picks one through a switch.
+    // Derivatives are taken outside of it so every sample gets the same ones
+    vec2 dx = dFdx(TexCoords);
+    vec2 dy = dFdy(TexCoords);
+
+    switch (Slot) {
+        case 1: color = textureGrad(images[1], TexCoords, dx, dy); break;
+        case 2: color = textureGrad(images[2], TexCoords, dx, dy); break;
+        case 3: color = textureGrad(images[3], TexCoords, dx, dy); break;
+        case 4: color = textureGrad(images[4], TexCoords, dx, dy); break;
+        case 5: color = textureGrad(images[5], TexCoords, dx, dy); break;
+        case 6: color = textureGrad(images[6], TexCoords, dx, dy); break;
+        case 7: color = textureGrad(images[7], TexCoords, dx, dy); break;
+        default: color = textureGrad(images[0], TexCoords, dx, dy); break;
+    }
+}
\ No newline at end of file
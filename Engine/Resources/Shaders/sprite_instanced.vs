@@ -0,0 +1,24 @@
+#version 450 core
+// One instance per sprite, the quad is expanded from gl_VertexID instead of being built on the CPU
+layout (location = 0) in vec4 dest;    // x, y, w, h in pixels
+layout (location = 1) in vec4 src;     // x, y, w, h normalized to the image
+layout (location = 2) in float slot;   // texture slot, 0 unless the renderer batches several textures
+
+out vec2 TexCoords;
+flat out int Slot;
+uniform mat4 projection;      // Screen coordinates to normalized
+uniform mat4 view;            // World to screen coordinates, identity for sprites already placed relative to the camera
+
+// Corners of the two triangles, in the order the other quad modes write them
+const vec2 corners[6] = vec2[](
+    vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(0.0, 0.0),   // Bottom Left, Top Right, Top Left
+    vec2(0.0, 1.0), vec2(1.0, 1.0), vec2(1.0, 0.0)    // Bottom Left, Bottom Right, Top Right
+);
+
+void main()
+{
+    vec2 corner = corners[gl_VertexID];
+    TexCoords = src.xy + corner * src.zw;
+    Slot = int(slot);
+    gl_Position = projection * view * vec4(dest.xy + corner * dest.zw, 0.0, 1.0);
+}
\ No newline at end of file
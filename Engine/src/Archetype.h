@@ -0,0 +1,219 @@
+#pragma once
+#include "Components/BaseComponent.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Archetype (chunked structure-of-arrays) storage for entities that share the exact same set of components.
+Each chunk holds up to CHUNK_SIZE rows and keeps every component type in its own contiguous column, so a system
+can walk e.g. all Transforms and all Srcs of a tile layer linearly instead of chasing one heap object per component.
+Components are constructed in place and never move once created (IComponent is not copyable or movable), so rows are
+only ever appended; the whole archetype is destroyed at once through clear() or the destructor.
+*/
+
+namespace ArchetypeDetail
+{
+	// Index of T inside the parameter pack Ts
+	template <typename T, typename... Ts>
+	struct IndexOf;
+
+	template <typename T, typename... Ts>
+	struct IndexOf<T, T, Ts...> : std::integral_constant<std::size_t, 0> {};
+
+	template <typename T, typename U, typename... Ts>
+	struct IndexOf<T, U, Ts...> : std::integral_constant<std::size_t, 1 + IndexOf<T, Ts...>::value> {};
+
+	template <typename T>
+	struct IsTuple : std::false_type {};
+
+	template <typename... Ts>
+	struct IsTuple<std::tuple<Ts...>> : std::true_type {};
+
+	// Constructs T in place from a tuple of constructor arguments, or from a single argument
+	template <typename T, typename Arg>
+	void construct(T* where, Arg&& arg)
+	{
+		if constexpr (IsTuple<std::decay_t<Arg>>::value)
+			std::apply([where](auto&&... a) { ::new (where) T(std::forward<decltype(a)>(a)...); }, std::forward<Arg>(arg));
+		else
+			::new (where) T(std::forward<Arg>(arg));
+	}
+
+	// Raw, correctly aligned storage for a column of COUNT objects of T
+	template <typename T, std::size_t COUNT>
+	struct Column
+	{
+		Column() {} // leave the bytes uninitialized, rows are constructed in place
+
+		T*       data() { return std::launder(reinterpret_cast<T*>(bytes)); }
+		const T* data() const { return std::launder(reinterpret_cast<const T*>(bytes)); }
+
+		alignas(T) unsigned char bytes[sizeof(T) * COUNT];
+	};
+}
+
+template <typename... Ts>
+class Archetype : public IComponent
+{
+	static_assert(sizeof...(Ts) > 0, "Archetype needs at least one component column");
+	static_assert((std::is_base_of_v<IComponent, Ts> && ...), "Archetype columns must be components");
+
+public:
+	static constexpr std::size_t CHUNK_SIZE = 256u; // rows per chunk
+
+	/* One allocation holding a CHUNK_SIZE slice of every column */
+	struct Chunk
+	{
+		std::tuple<ArchetypeDetail::Column<Ts, CHUNK_SIZE>...> columns;
+		std::size_t                                          size{0};
+
+		template <typename T>
+		T* column()
+		{
+			return std::get<ArchetypeDetail::IndexOf<T, Ts...>::value>(columns).data();
+		}
+	};
+
+	Archetype() = default;
+
+	~Archetype() override
+	{
+		clear();
+	}
+
+	// Appends a row, constructing every column in place from the matching argument (one per column, a tuple for several constructor arguments)
+	template <typename... TArgs>
+	std::size_t emplace_back(TArgs&&... args)
+	{
+		static_assert(sizeof...(TArgs) == sizeof...(Ts), "emplace_back needs one argument per column");
+
+		auto& chunk = backChunk();
+		const auto row = chunk.size;
+		(ArchetypeDetail::construct(chunk.template column<Ts>() + row, std::forward<TArgs>(args)), ...);
+		++chunk.size;
+		return m_size++;
+	}
+
+	// Allocates every chunk needed to hold count rows up front
+	void reserve(const std::size_t count)
+	{
+		const auto chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		m_chunks.reserve(chunks);
+		while (m_chunks.size() < chunks)
+			m_chunks.push_back(std::unique_ptr<Chunk>(new Chunk));
+	}
+
+	// Creates count rows in one go, init(i) returns a tuple with the emplace_back arguments of row i.
+	// Every chunk is allocated up front and then filled a whole column run at a time, without a per row chunk lookup
+	template <typename Fn>
+	void createMany(const std::size_t count, Fn&& init)
+	{
+		reserve(m_size + count);
+
+		for (std::size_t i = 0; i < count;) {
+			auto&      chunk = *m_chunks[m_size / CHUNK_SIZE];
+			const auto rows  = std::min(count - i, CHUNK_SIZE - chunk.size);
+			const auto cols  = std::make_tuple((chunk.template column<Ts>() + chunk.size)...);
+
+			for (std::size_t row = 0; row < rows; ++row, ++i)
+				constructRow(cols, row, init(i), std::index_sequence_for<Ts...>{});
+
+			chunk.size += rows;
+			m_size += rows;
+		}
+	}
+
+	// Gets the component of type T stored at row
+	template <typename T>
+	T& get(const std::size_t row)
+	{
+		return m_chunks[row / CHUNK_SIZE]->template column<T>()[row % CHUNK_SIZE];
+	}
+
+	// Calls fn(Ts&...) for every row in insertion order
+	template <typename Fn>
+	void each(Fn&& fn)
+	{
+		for (auto& chunk : m_chunks) {
+			auto cols = std::make_tuple(chunk->template column<Ts>()...);
+			for (std::size_t i = 0; i < chunk->size; ++i)
+				std::apply([&fn, i](Ts*... col) { fn(col[i]...); }, cols);
+		}
+	}
+
+	// Calls fn(count, Ts*...) once per chunk with pointers to the start of each column, for tight per-column loops
+	template <typename Fn>
+	void eachChunk(Fn&& fn)
+	{
+		for (auto& chunk : m_chunks)
+			fn(chunk->size, chunk->template column<Ts>()...);
+	}
+
+	// eachChunk over the rows [begin, end) only, fn is called once per chunk the range touches
+	template <typename Fn>
+	void eachRange(std::size_t begin, std::size_t end, Fn&& fn)
+	{
+		end = std::min(end, m_size);
+		while (begin < end) {
+			auto&      chunk  = *m_chunks[begin / CHUNK_SIZE];
+			const auto offset = begin % CHUNK_SIZE;
+			const auto count  = std::min(end - begin, CHUNK_SIZE - offset);
+
+			fn(count, (chunk.template column<Ts>() + offset)...);
+			begin += count;
+		}
+	}
+
+	std::size_t size() const
+	{
+		return m_size;
+	}
+
+	std::size_t chunkCount() const
+	{
+		return m_chunks.size();
+	}
+
+	// Destroys every row and frees all chunks
+	void clear()
+	{
+		for (auto& chunk : m_chunks)
+			destroy(*chunk);
+		m_chunks.clear();
+		m_size = 0;
+	}
+
+private:
+	// Chunk the next row goes into, reserved chunks are filled in order
+	Chunk& backChunk()
+	{
+		const auto index = m_size / CHUNK_SIZE;
+		if (index == m_chunks.size())
+			m_chunks.push_back(std::unique_ptr<Chunk>(new Chunk));
+		return *m_chunks[index];
+	}
+
+	// Constructs row of every column from the matching element of args
+	template <typename Args, std::size_t... Is>
+	static void constructRow(const std::tuple<Ts*...>& cols, const std::size_t row, Args&& args, std::index_sequence<Is...>)
+	{
+		(ArchetypeDetail::construct(std::get<Is>(cols) + row, std::get<Is>(std::forward<Args>(args))), ...);
+	}
+
+	static void destroy(Chunk& chunk)
+	{
+		for (std::size_t i = 0; i < chunk.size; ++i)
+			(chunk.template column<Ts>()[i].~Ts(), ...);
+		chunk.size = 0;
+	}
+
+	std::vector<std::unique_ptr<Chunk>> m_chunks{};
+	std::size_t                         m_size{0};
+};
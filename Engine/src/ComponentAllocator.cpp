@@ -0,0 +1,156 @@
+#include "ComponentAllocator.h"
+
+#include <algorithm>
+#include <new>
+
+namespace
+{
+	constexpr std::size_t MAX_SLAB_BLOCKS = 1u << 16;
+}
+
+std::atomic<std::size_t> ComponentAllocator::s_heapLive{0u};
+
+void* ComponentAllocator::Pool::allocate()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_freeList)
+		grow(m_nextSlabBlocks);
+
+	const auto block = m_freeList;
+	m_freeList = block->next;
+	++m_live;
+	return block;
+}
+
+void ComponentAllocator::Pool::deallocate(void* block)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = m_freeList;
+	m_freeList = freeBlock;
+	--m_live;
+}
+
+void ComponentAllocator::Pool::reserve(const std::size_t count)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto available = m_capacity - m_live;
+	if (count > available)
+		grow(count - available);
+}
+
+void ComponentAllocator::Pool::grow(const std::size_t blocks)
+{
+	const auto slab = new unsigned char[blocks * blockSize];
+	m_slabs.push_back(slab);
+
+	// Thread the new blocks onto the free list in address order
+	for (auto i = blocks; i-- > 0;) {
+		const auto block = reinterpret_cast<FreeBlock*>(slab + i * blockSize);
+		block->next = m_freeList;
+		m_freeList = block;
+	}
+
+	m_capacity += blocks;
+	m_nextSlabBlocks = std::min(std::max(m_nextSlabBlocks, blocks) * 2, MAX_SLAB_BLOCKS);
+}
+
+std::size_t ComponentAllocator::Pool::capacity() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_capacity;
+}
+
+std::size_t ComponentAllocator::Pool::live() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_live;
+}
+
+std::array<ComponentAllocator::Pool, ComponentAllocator::MAX_POOLED_SIZE / ComponentAllocator::ALIGNMENT>& ComponentAllocator::pools()
+{
+	// Function local so components created during static initialization (Game::Global) already have pools to use. Never destroyed:
+	// components owned by statics (Game::Registry, Game::Global) can be freed at exit after any destructor registered here would run
+	struct Pools
+	{
+		Pools()
+		{
+			for (auto i = 0u; i < pools.size(); ++i)
+				pools[i].blockSize = (i + 1) * ALIGNMENT;
+		}
+
+		std::array<Pool, MAX_POOLED_SIZE / ALIGNMENT> pools;
+	};
+	static const auto storage = new Pools();
+
+	return storage->pools;
+}
+
+ComponentAllocator::Pool& ComponentAllocator::poolFor(const std::size_t size)
+{
+	return pools()[sizeClass(size)];
+}
+
+void* ComponentAllocator::allocate(const std::size_t size)
+{
+	if (size > MAX_POOLED_SIZE) {
+		++s_heapLive;
+		return ::operator new(size);
+	}
+
+	return poolFor(size).allocate();
+}
+
+void ComponentAllocator::deallocate(void* ptr, const std::size_t size)
+{
+	if (!ptr)
+		return;
+
+	if (size > MAX_POOLED_SIZE) {
+		--s_heapLive;
+		::operator delete(ptr);
+		return;
+	}
+
+	poolFor(size).deallocate(ptr);
+}
+
+void ComponentAllocator::reserve(const std::size_t size, const std::size_t count)
+{
+	if (size <= MAX_POOLED_SIZE)
+		poolFor(size).reserve(count);
+}
+
+std::size_t ComponentAllocator::capacity()
+{
+	std::size_t bytes = 0u;
+	for (const auto& pool : pools())
+		bytes += pool.capacity() * pool.blockSize;
+	return bytes;
+}
+
+std::size_t ComponentAllocator::live()
+{
+	std::size_t objects = 0u;
+	for (const auto& pool : pools())
+		objects += pool.live();
+	return objects;
+}
+
+std::size_t ComponentAllocator::heapLive()
+{
+	return s_heapLive;
+}
+
+float ComponentAllocator::freeRatio()
+{
+	std::size_t blocks = 0u, used = 0u;
+	for (const auto& pool : pools()) {
+		blocks += pool.capacity();
+		used += pool.live();
+	}
+	return blocks ? 1.0f - static_cast<float>(used) / static_cast<float>(blocks) : 0.0f;
+}
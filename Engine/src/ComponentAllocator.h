@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/*
+Pool allocator used for every component created with new (Entity::addComponent, addIDComponent, push_back...).
+Components are grouped by size class (16 byte steps up to MAX_POOLED_SIZE), so each component type draws from the pool of its size
+and a tile map of thousands of components costs a handful of slab allocations instead of one heap allocation per component.
+Slabs double in size as a pool grows and freed blocks are kept in an intrusive free list for reuse.
+Anything bigger than MAX_POOLED_SIZE falls back to the global heap.
+The pools are never destroyed, their slabs are released by the OS at exit.
+Systems run on job system workers may create and destroy components, so every pool is guarded by a mutex of its own.
+*/
+class ComponentAllocator
+{
+public:
+	static constexpr std::size_t ALIGNMENT       = 16u;
+	static constexpr std::size_t MAX_POOLED_SIZE = 512u;
+
+	/* Fixed block size pool carved out of growing slabs */
+	class Pool
+	{
+	public:
+		Pool() = default;
+
+		Pool(const Pool&) = delete;
+		Pool& operator=(const Pool&) = delete;
+
+		void* allocate();
+		void  deallocate(void* block);
+
+		// Makes sure count more blocks can be handed out without touching the heap
+		void reserve(std::size_t count);
+
+		// Blocks owned by the pool
+		std::size_t capacity() const;
+
+		// Blocks currently handed out
+		std::size_t live() const;
+
+		std::size_t blockSize{0};
+
+	private:
+		void grow(std::size_t blocks);
+
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		mutable std::mutex          m_mutex{};	// guards everything below
+		std::vector<unsigned char*> m_slabs{};
+		FreeBlock*                  m_freeList{nullptr};
+		std::size_t                 m_nextSlabBlocks{64};
+		std::size_t                 m_capacity{0};
+		std::size_t                 m_live{0};
+	};
+
+	ComponentAllocator() = delete;
+
+	static void* allocate(std::size_t size);
+	static void  deallocate(void* ptr, std::size_t size);
+
+	// Pre-sizes the pool for objects of size bytes so count of them can be created in one go
+	static void reserve(std::size_t size, std::size_t count);
+
+	// Pre-sizes the pools for count objects of each of Ts, types sharing a size class add up in their common pool
+	template <typename... Ts>
+	static void reserve(const std::size_t count)
+	{
+		constexpr std::array<std::size_t, sizeof...(Ts)> sizes{ sizeof(Ts)... };
+		for (std::size_t i = 0; i < sizes.size(); ++i) {
+			// The first type of each size class reserves for every type in it
+			std::size_t types = 0;
+			bool        first = true;
+			for (std::size_t j = 0; j < sizes.size(); ++j)
+				if (sizeClass(sizes[j]) == sizeClass(sizes[i])) {
+					first = first && j >= i;
+					++types;
+				}
+
+			if (first)
+				reserve(sizes[i], types * count);
+		}
+	}
+
+	// Bytes owned by all pools
+	static std::size_t capacity();
+	// Pooled components that are currently alive
+	static std::size_t live();
+	// Components too big to be pooled that are currently alive on the global heap
+	static std::size_t heapLive();
+	// Share of pooled blocks that are free (0 = every block in use, 1 = nothing in use)
+	static float freeRatio();
+
+private:
+	// Index of the pool serving objects of size bytes
+	static constexpr std::size_t sizeClass(const std::size_t size)
+	{
+		return ((size ? size : 1u) + ALIGNMENT - 1) / ALIGNMENT - 1;
+	}
+
+	static std::array<Pool, MAX_POOLED_SIZE / ALIGNMENT>& pools();
+	static Pool& poolFor(std::size_t size);
+
+	static std::atomic<std::size_t> s_heapLive;
+};
@@ -1,4 +1,7 @@
 #pragma once
+#include "ComponentAllocator.h"
+
+#include <cstddef>
 
 /* Stores generics and data structures for systems to manipulate and display on screen */
 class IComponent
@@ -14,5 +17,9 @@ public:
 	IComponent(const IComponent&) = delete;
 	IComponent& operator=(IComponent&&) = delete;
 	IComponent& operator=(const IComponent&) = delete;
+
+	// Components come out of size class pools, the virtual destructor makes delete pass the size of the most derived type
+	static void* operator new(const std::size_t size) { return ComponentAllocator::allocate(size); }
+	static void operator delete(void* ptr, const std::size_t size) { ComponentAllocator::deallocate(ptr, size); }
 };
 
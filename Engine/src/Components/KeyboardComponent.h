@@ -1,8 +1,11 @@
 ﻿#pragma once
 #include "Components/ControllerComponent.h"
-#include <GLFW/glfw3.h>
 #include "Game.h"
 
+#ifndef HEADLESS_ONLY
+#include <GLFW/glfw3.h>
+#endif
+
 namespace ControllerComponent
 {
 	/*
@@ -14,19 +17,20 @@ namespace ControllerComponent
 	*/
 	class Keyboard : public Component::IController
 	{
+	public:
+		// GLFW key codes, spelled out so headless builds don't need GLFW
 		enum KeyID
 		{
-			Left = GLFW_KEY_LEFT,
-			Right = GLFW_KEY_RIGHT,
-			Down = GLFW_KEY_DOWN,
-			Up = GLFW_KEY_UP,
-			W = GLFW_KEY_W,
-			A = GLFW_KEY_A,
-			S = GLFW_KEY_S,
-			D = GLFW_KEY_D,
+			Left = 263,
+			Right = 262,
+			Down = 264,
+			Up = 265,
+			W = 87,
+			A = 65,
+			S = 83,
+			D = 68,
 		};
 
-	public:
 		Keyboard() = default;
 
 		bool keyDownUp() override
@@ -49,4 +53,10 @@ namespace ControllerComponent
 			return Game::keys[Right] || Game::keys[D];
 		}
 	};
+
+#ifndef HEADLESS_ONLY
+	static_assert(Keyboard::Left == GLFW_KEY_LEFT && Keyboard::Right == GLFW_KEY_RIGHT && Keyboard::Down == GLFW_KEY_DOWN && Keyboard::Up == GLFW_KEY_UP &&
+				  Keyboard::W == GLFW_KEY_W && Keyboard::A == GLFW_KEY_A && Keyboard::S == GLFW_KEY_S && Keyboard::D == GLFW_KEY_D,
+				  "Keyboard key ids out of sync with GLFW");
+#endif
 }
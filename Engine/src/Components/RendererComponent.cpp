@@ -1,25 +1,96 @@
 #include "RendererComponent.h"
 
+#include "Profiler.h"
+
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 namespace
 {
 	constexpr auto VERTICES = 6u;
+
+	// Slot i samples texture unit i
+	constexpr GLint UNITS[Component::Renderer::MAX_TEXTURE_SLOTS] = { 0, 1, 2, 3, 4, 5, 6, 7 };
 }
 
 namespace Component
 {
-	Renderer::Renderer(const std::vector<unsigned int>& attributes, const unsigned int maxSprites)
-		: m_maxSprites(maxSprites)
+	StaticQuads::StaticQuads(StaticQuads&& other) noexcept
+		: m_vao(other.m_vao), m_vbo(other.m_vbo), m_quads(other.m_quads), m_capacity(other.m_capacity)
+	{
+		other.m_vao = 0;
+		other.m_vbo = 0;
+		other.m_quads = 0;
+		other.m_capacity = 0;
+	}
+
+	StaticQuads& StaticQuads::operator=(StaticQuads&& other) noexcept
+	{
+		if (this != &other) {
+			release();
+			m_vao = other.m_vao;
+			m_vbo = other.m_vbo;
+			m_quads = other.m_quads;
+			m_capacity = other.m_capacity;
+			other.m_vao = 0;
+			other.m_vbo = 0;
+			other.m_quads = 0;
+			other.m_capacity = 0;
+		}
+
+		return *this;
+	}
+
+	void StaticQuads::release()
+	{
+		if (m_vbo)
+			glDeleteBuffers(1, &m_vbo);
+		if (m_vao)
+			glDeleteVertexArrays(1, &m_vao);
+		m_vbo = m_vao = 0;
+		m_quads = m_capacity = 0;
+	}
+
+	Renderer::Renderer(const std::vector<unsigned int>& attributes,
+					   const unsigned int               maxSprites,
+					   const QuadMode                   quadMode,
+					   const Streaming                  streaming,
+					   const unsigned int               textureSlots)
+		: m_quadMode(quadMode),
+		  m_maxSprites(maxSprites),
+		  m_batchLimit(static_cast<std::size_t>(maxSprites) * maxSprites * VERTICES),
+		  m_textureSlots(std::clamp(textureSlots, 1u, MAX_TEXTURE_SLOTS))
 	{
 		Logger::message("Initializing Renderer (Max Sprites = " + std::to_string(maxSprites));
 		
 
+		// Instances replace vertices, their layout is fixed: dest and src as two vec4 per sprite
+		m_layout = attributes;
+		if (m_quadMode == QuadMode::Instanced)
+			m_layout = { 4u, 4u };
+
+		// Batches sharing texture slots add the slot after the other attributes
+		if (m_textureSlots > 1u)
+			m_layout.push_back(1u);
+
 		// Calculate total attribute size	
-		for (const auto attrib : attributes) {
+		for (const auto attrib : m_layout) {
 			m_attribSize += attrib;
 		}
 
+		switch (m_quadMode) {
+			case QuadMode::Triangles: m_quadFloats = 6u * m_attribSize;
+				break;
+			case QuadMode::Indexed: m_quadFloats = 4u * m_attribSize;
+				break;
+			case QuadMode::Instanced: m_quadFloats = m_attribSize;
+				break;
+		}
+
+		// Batches and regions hold whole quads, so every batch starts on a vertex (or instance) boundary
+		m_batchLimit -= m_batchLimit % m_quadFloats;
+
 		// Create buffers in GPU
 		glGenVertexArrays(1, &m_vao);
 		glGenBuffers(1, &m_vbo);
@@ -28,12 +99,49 @@ namespace Component
 		glBindVertexArray(m_vao);
 		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
-		// Create and bind attributes to vbo
-		auto ptrStride = 0ull;
-		for (auto i = 0u; i < attributes.size(); ++i) {
-			glVertexAttribPointer(i, static_cast<GLint>(attributes[i]), GL_FLOAT, GL_FALSE, static_cast<GLsizei>(m_attribSize * sizeof(float)), reinterpret_cast<GLvoid*>(ptrStride));
-			glEnableVertexAttribArray(i);
-			ptrStride += attributes[i] * sizeof(float);
+		// Storage comes before the attributes, the vao keeps pointing at whichever buffer is bound when they are set up
+		const auto regionBytes = static_cast<GLsizeiptr>(m_batchLimit * sizeof(float));
+
+		// Immutable storage mapped once, needs OpenGL 4.4
+		if (streaming == Streaming::Persistent && GLAD_GL_VERSION_4_4) {
+			constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+			glBufferStorage(GL_ARRAY_BUFFER, regionBytes * static_cast<GLsizeiptr>(REGIONS), nullptr, flags);
+			m_mapped = static_cast<float*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, regionBytes * static_cast<GLsizeiptr>(REGIONS), flags));
+
+			if (!m_mapped) {
+				// Immutable storage can't be respecified, start over with a fresh buffer
+				Logger::warning("Failed to map the renderer's vertex buffer, falling back to orphaning", Logger::SEVERITY::LOW);
+				glDeleteBuffers(1, &m_vbo);
+				glGenBuffers(1, &m_vbo);
+				glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+			}
+		}
+		else if (streaming == Streaming::Persistent) {
+			Logger::message("Persistent buffer mapping needs OpenGL 4.4, renderer streaming by orphaning");
+		}
+
+		if (m_mapped)
+			Logger::message("Renderer streaming through a persistently mapped buffer (" + std::to_string(REGIONS) + " regions)");
+		else
+			glBufferData(GL_ARRAY_BUFFER, regionBytes, nullptr, GL_STREAM_DRAW);
+
+		setAttributes();
+
+		if (m_quadMode == QuadMode::Indexed) {
+			// Every batch uses the same indices, corners are written as bottom left, top right, top left, bottom right
+			const auto           quads = m_batchLimit / m_quadFloats;
+			std::vector<GLuint> indices(quads * 6u);
+			for (std::size_t quad = 0; quad < quads; ++quad) {
+				const auto corner = static_cast<GLuint>(quad * 4u);
+				for (std::size_t i = 0; i < QUAD_INDICES.size(); ++i)
+					indices[quad * 6u + i] = corner + QUAD_INDICES[i];
+			}
+
+			// The element buffer binding is part of the vao
+			glGenBuffers(1, &m_ibo);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(GLuint)), indices.data(), GL_STATIC_DRAW);
 		}
 	}
 
@@ -41,13 +149,27 @@ namespace Component
 	Renderer::Renderer(Renderer&& other) noexcept
 		: m_vbo(other.m_vbo)
 	, m_vao(other.m_vao)
+	, m_ibo(other.m_ibo)
+	, m_quadMode(other.m_quadMode)
+	, m_quadFloats(other.m_quadFloats)
+	, m_layout(std::move(other.m_layout))
 	, m_attribSize(other.m_attribSize)
 	, m_maxSprites(other.m_maxSprites)
+	, m_batchLimit(other.m_batchLimit)
 	, m_currentMaterial(nullptr)
+	, m_textureSlots(other.m_textureSlots)
+	, m_mapped(other.m_mapped)
+	, m_fences(other.m_fences)
+	, m_region(other.m_region)
+	, m_batchStart(other.m_batchStart)
+	, m_batchEnd(other.m_batchEnd)
 	{
 		// make the assigning renderer useless
 		other.m_vbo = 0;
 		other.m_vao = 0;
+		other.m_ibo = 0;
+		other.m_mapped = nullptr;
+		other.m_fences.fill(nullptr);
 	}
 
 	Renderer& Renderer::operator=(Renderer&& other) noexcept
@@ -57,10 +179,26 @@ namespace Component
 			release();
 			m_vbo = other.m_vbo;
 			m_vao = other.m_vao;
+			m_ibo = other.m_ibo;
+			m_quadMode = other.m_quadMode;
+			m_quadFloats = other.m_quadFloats;
+			m_layout = std::move(other.m_layout);
+			m_attribSize = other.m_attribSize;
+			m_textureSlots = other.m_textureSlots;
+			m_slotsUsed = 0;
 			m_currentMaterial = other.m_currentMaterial;
 			m_maxSprites = other.m_maxSprites;
+			m_batchLimit = other.m_batchLimit;
+			m_mapped = other.m_mapped;
+			m_fences = other.m_fences;
+			m_region = other.m_region;
+			m_batchStart = other.m_batchStart;
+			m_batchEnd = other.m_batchEnd;
 			other.m_vbo = 0;
 			other.m_vao = 0;
+			other.m_ibo = 0;
+			other.m_mapped = nullptr;
+			other.m_fences.fill(nullptr);
 
 		}
 
@@ -69,15 +207,6 @@ namespace Component
 
 	void Renderer::draw(const Rect& src, const Rect& dest, Component::Material& mat)
 	{
-		// Checks if buffer is over sprite limit or current material isn't set
-		// Finally checks if the current material has a different id from the new material
-		if ((m_buffer.size() >= static_cast<std::size_t>(m_maxSprites) * m_maxSprites * VERTICES || !m_currentMaterial)
-			|| m_currentMaterial->id != mat.id) {
-			// Flush out current batch and start on the next one
-			flush();
-			m_currentMaterial = &mat;
-		}
-
 		// Translate source to fractions of the image dimensions (automatically normalize)
 		Rect       normSrc   = src;
 		const auto imgWidth  = static_cast<GLfloat>(mat.texture.width);
@@ -88,58 +217,87 @@ namespace Component
 		normSrc.w /= imgWidth;
 		normSrc.h /= imgHeight;
 
+		writeQuad(reserveQuads(1u, mat), dest, normSrc);
+	}
 
-		// Set up vertex data and create a quad using 2 triangles
+	float* Renderer::reserveQuads(const std::size_t count, Component::Material& mat)
+	{
+		const auto floats = count * quadFloats();
 
-		// First triangle
-		// Bottom Left
-		m_buffer.push_back(dest.x);
-		m_buffer.push_back(dest.y + dest.h);
-		m_buffer.push_back(normSrc.x);
-		m_buffer.push_back(normSrc.y + normSrc.h);
+		// A batch never grows past the limit, so the index buffer always covers it
+		if (floats > m_batchLimit)
+			Logger::error("Can't reserve " + std::to_string(count) + " quads, a batch only holds " + std::to_string(m_batchLimit / quadFloats()), Logger::SEVERITY::HIGH);
 
-		//  Top Right
-		m_buffer.push_back(dest.x + dest.w);
-		m_buffer.push_back(dest.y);
-		m_buffer.push_back(normSrc.x + normSrc.w);
-		m_buffer.push_back(normSrc.y);
+		// Checks if buffer would go over the sprite limit or current material isn't set
+		// Finally checks if the new material can't share the current batch
+		if ((pending() + floats > m_batchLimit || !m_currentMaterial)
+			|| !batches(mat)) {
+			// Flush out current batch and start on the next one
+			flush();
+			m_currentMaterial = &mat;
+		}
 
-		// Top Left
-		m_buffer.push_back(dest.x);
-		m_buffer.push_back(dest.y);
-		m_buffer.push_back(normSrc.x);
-		m_buffer.push_back(normSrc.y);
+		// Draw what fits in this region and continue the batch in the next one
+		if (m_mapped && m_batchEnd + floats > (m_region + 1) * m_batchLimit) {
+			flush();
+			nextRegion();
+		}
+
+		// The quads sample the texture through the slot it's bound to when the batch is drawn
+		m_slot = static_cast<float>(slotOf(mat.texture));
+
+		if (!m_mapped) {
+			const auto offset = m_buffer.size();
+			m_buffer.resize(offset + floats);
+			return m_buffer.data() + offset;
+		}
+
+		const auto out = m_mapped + m_batchEnd;
+		m_batchEnd += floats;
+		return out;
+	}
+
+	bool Renderer::batches(const Component::Material& mat) const
+	{
+		// A single texture slot batches one material at a time
+		if (m_textureSlots == 1u)
+			return m_currentMaterial->id == mat.id;
 
-		// Second Triangle
-		// Bottom Left
-		m_buffer.push_back(dest.x);
-		m_buffer.push_back(dest.y + dest.h);
-		m_buffer.push_back(normSrc.x);
-		m_buffer.push_back(normSrc.y + normSrc.h);
+		if (m_currentMaterial->shader.getID() != mat.shader.getID())
+			return false;
 
-		// Bottom Right
-		m_buffer.push_back(dest.x + dest.w);
-		m_buffer.push_back(dest.y + dest.h);
-		m_buffer.push_back(normSrc.x + normSrc.w);
-		m_buffer.push_back(normSrc.y + normSrc.h);
+		const auto used = m_slotTextures.begin() + m_slotsUsed;
+		return m_slotsUsed < m_textureSlots || std::find(m_slotTextures.begin(), used, &mat.texture) != used;
+	}
+
+	unsigned int Renderer::slotOf(Component::Texture& texture)
+	{
+		if (m_textureSlots == 1u)
+			return 0u;
+
+		const auto used = m_slotTextures.begin() + m_slotsUsed;
+		const auto slot = std::find(m_slotTextures.begin(), used, &texture);
+		if (slot != used)
+			return static_cast<unsigned int>(slot - m_slotTextures.begin());
 
-		// Top Right
-		m_buffer.push_back(dest.x + dest.w);
-		m_buffer.push_back(dest.y);
-		m_buffer.push_back(normSrc.x + normSrc.w);
-		m_buffer.push_back(normSrc.y);
+		m_slotTextures[m_slotsUsed] = &texture;
+		return m_slotsUsed++;
 	}
 
 	void Renderer::display()
 	{
-		// Re-buffer changes to data
-		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_buffer.size() * sizeof(float)), m_buffer.data(), GL_STATIC_DRAW);
+		PROFILE_SCOPE("Renderer::display");
 
-		// Draw triangles
-		glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_buffer.size() / m_attribSize));
+		if (pending())
+			submit();
 
-		// Clear buffer for next cycle
-		m_buffer.clear();
+		m_frameDrawCalls = m_drawCalls;
+		m_drawCalls = 0;
+		m_frameUploadedBytes = m_uploadedBytes;
+		m_uploadedBytes = 0;
+
+		// Every draw of the frame is submitted, the next frame writes to the next region
+		nextRegion();
 	}
 
 	void Renderer::clear(const float r, const float g, const float b, const float a)
@@ -154,43 +312,229 @@ namespace Component
 	{
 		Logger::message("Destroying Renderer");
 
+		// Deleting the buffer unmaps it
+		for (auto& fence : m_fences) {
+			if (fence)
+				glDeleteSync(fence);
+			fence = nullptr;
+		}
+		m_mapped = nullptr;
+
 		// Delete buffers if they exist
 		if (m_vbo)
 			glDeleteBuffers(1, &m_vbo);
+		if (m_ibo)
+			glDeleteBuffers(1, &m_ibo);
 		if (m_vao)
 			glDeleteBuffers(1, &m_vao);
 	}
 
 	void Renderer::flush()
 	{
-		if (m_buffer.empty()) return;
+		if (!pending()) return;
+
+		PROFILE_SCOPE("Renderer::flush");
 
 		// Make sure the current batch is clear and ready to used
 		if (!m_currentMaterial) {
 			m_buffer.clear();
+			m_batchStart = m_batchEnd;
+			m_slotsUsed = 0;
 			return;
 		}
 
-		// Set uniforms and use shader
-		m_currentMaterial->compile();
+		if (m_textureSlots > 1u) {
+			// Every texture of the batch is bound to the unit of its slot
+			m_currentMaterial->shader.use();
+			m_currentMaterial->shader.setIntArray("images", UNITS, static_cast<GLsizei>(m_textureSlots));
 
-		// Bind texture to appropriate slot
-		m_currentMaterial->bind();
+			for (auto slot = 0u; slot < m_slotsUsed; ++slot) {
+				glActiveTexture(GL_TEXTURE0 + slot);
+				m_slotTextures[slot]->bind();
+			}
+		}
+		else {
+			// Set uniforms and use shader
+			m_currentMaterial->compile();
 
-		// Re-buffer changes to data
-		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_buffer.size() * sizeof(GLfloat)), m_buffer.data(), GL_STATIC_DRAW);
+			// Bind texture to appropriate slot
+			m_currentMaterial->bind();
+		}
 
-		// Draw triangles
-		glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_buffer.size() / m_attribSize));
+		submit();
+	}
+
+	void Renderer::submit()
+	{
+		m_uploadedBytes += pending() * sizeof(float);
+
+		if (m_mapped) {
+			// The vertices are already in place, draw them where the batch starts
+			drawQuads(m_batchStart / m_attribSize, pending());
+			m_batchStart = m_batchEnd;
+			return;
+		}
+
+		{
+			PROFILE_SCOPE("Renderer::upload");
+
+			// Orphan the old storage so the driver never waits for draws still reading it, then re-buffer changes to data
+			const auto bytes = static_cast<GLsizeiptr>(std::max(m_buffer.size(), m_batchLimit) * sizeof(GLfloat));
+			glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(m_buffer.size() * sizeof(GLfloat)), m_buffer.data());
+		}
+
+		drawQuads(0u, m_buffer.size());
 
 		// Clear buffer for next cycle
 		m_buffer.clear();
 	}
 
+	void Renderer::drawQuads(const std::size_t first, const std::size_t floats)
+	{
+		const auto vertices = floats / m_attribSize;
+
+		// The next batch starts with every texture slot free
+		m_slotsUsed = 0;
+		++m_drawCalls;
+
+		// Draw triangles, indexed ones always start at the first index and are offset to the batch's vertices.
+		// Instanced ones draw the 6 vertices the vertex shader expands every instance into
+		switch (m_quadMode) {
+			case QuadMode::Triangles: glDrawArrays(GL_TRIANGLES, static_cast<GLint>(first), static_cast<GLsizei>(vertices));
+				break;
+			case QuadMode::Indexed: glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(vertices / 4u * 6u), GL_UNSIGNED_INT, nullptr, static_cast<GLint>(first));
+				break;
+			case QuadMode::Instanced: glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(vertices), static_cast<GLuint>(first));
+				break;
+		}
+	}
+
+	void Renderer::upload(StaticQuads& quads, const std::vector<float>& vertices)
+	{
+		PROFILE_SCOPE("Renderer::uploadStatic");
+
+		// Indexed quads share the batches' index buffer, which covers a batch
+		const auto count = vertices.size() / m_quadFloats;
+		if (count > batchQuads())
+			Logger::error("Can't upload " + std::to_string(count) + " static quads, a batch only holds " + std::to_string(batchQuads()), Logger::SEVERITY::HIGH);
+
+		if (!quads.m_vao) {
+			glGenVertexArrays(1, &quads.m_vao);
+			glGenBuffers(1, &quads.m_vbo);
+
+			glBindVertexArray(quads.m_vao);
+			glBindBuffer(GL_ARRAY_BUFFER, quads.m_vbo);
+			setAttributes();
+			if (m_ibo)
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+		}
+		else
+			glBindBuffer(GL_ARRAY_BUFFER, quads.m_vbo);
+
+		// Only grow the storage, smaller uploads reuse it
+		const auto bytes = vertices.size() * sizeof(float);
+		if (bytes > quads.m_capacity) {
+			glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), vertices.data(), GL_STATIC_DRAW);
+			quads.m_capacity = bytes;
+		}
+		else
+			glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(bytes), vertices.data());
+
+		quads.m_quads = count;
+		m_uploadedBytes += bytes;
+
+		// Back to the batch's buffers
+		glBindVertexArray(m_vao);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	}
+
+	void Renderer::drawStatic(const StaticQuads& quads, Component::Material& mat, const glm::mat4& view)
+	{
+		if (!quads.m_quads)
+			return;
+
+		PROFILE_SCOPE("Renderer::drawStatic");
+
+		// Keep the order things were drawn in, then start the next batch from scratch since its material gets unbound
+		flush();
+		m_currentMaterial = nullptr;
+
+		bindStatic(mat);
+		mat.shader.setMat4("view", view);
+
+		glBindVertexArray(quads.m_vao);
+		drawQuads(0u, quads.m_quads * m_quadFloats);
+		glBindVertexArray(m_vao);
+
+		// Batched quads are already placed relative to the camera
+		mat.shader.setMat4("view", glm::mat4(1.0f));
+	}
+
+	void Renderer::setAttributes() const
+	{
+		// Create and bind attributes to vbo
+		auto ptrStride = 0ull;
+		for (auto i = 0u; i < m_layout.size(); ++i) {
+			glVertexAttribPointer(i, static_cast<GLint>(m_layout[i]), GL_FLOAT, GL_FALSE, static_cast<GLsizei>(m_attribSize * sizeof(float)), reinterpret_cast<GLvoid*>(ptrStride));
+			glEnableVertexAttribArray(i);
+			ptrStride += m_layout[i] * sizeof(float);
+
+			// Instanced attributes advance once per sprite, not per vertex
+			if (m_quadMode == QuadMode::Instanced)
+				glVertexAttribDivisor(i, 1u);
+		}
+	}
+
+	void Renderer::bindStatic(Component::Material& mat) const
+	{
+		if (m_textureSlots > 1u) {
+			mat.shader.use();
+			mat.shader.setIntArray("images", UNITS, static_cast<GLsizei>(m_textureSlots));
+
+			glActiveTexture(GL_TEXTURE0);
+			mat.texture.bind();
+		}
+		else {
+			mat.compile();
+			mat.bind();
+		}
+	}
+
+	std::size_t Renderer::pending() const
+	{
+		return m_mapped ? m_batchEnd - m_batchStart : m_buffer.size();
+	}
+
+	void Renderer::nextRegion()
+	{
+		if (!m_mapped)
+			return;
+
+		m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_region = (m_region + 1) % REGIONS;
+
+		// The region was last written REGIONS frames ago, wait until the GPU has read it
+		if (auto& fence = m_fences[m_region]) {
+			PROFILE_SCOPE("Renderer::wait");
+
+			constexpr GLuint64 TIMEOUT = 1000000;	// nanoseconds
+			auto               result  = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT);
+			while (result == GL_TIMEOUT_EXPIRED)
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT);
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		m_batchStart = m_batchEnd = m_region * m_batchLimit;
+	}
+
 	void Renderer::beginDraw()
 	{
 		// Make sure we aren't batching with previous material
 		m_currentMaterial = nullptr;
+		m_slotsUsed = 0;
 	}
 
 	void Renderer::endDraw()
@@ -2,19 +2,91 @@
 #include "Components/BaseComponent.h"
 #include "Components/MaterialComponent.h"
 #include "Components/RectComponent.h"
+#include "Components/TextureComponent.h"
 
 #include <glad/glad.h>
+#include <glm/mat4x4.hpp>
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 namespace Component
 {
-	/* Simple batch renderer for drawing sprites from the same image and shader */
+	/* Quads uploaded once into buffers of their own and drawn from them until uploaded again, see Renderer::upload and Renderer::drawStatic */
+	class StaticQuads
+	{
+	public:
+		StaticQuads() = default;
+
+		StaticQuads(const StaticQuads&) = delete;
+
+		StaticQuads(StaticQuads&& other) noexcept;
+
+		StaticQuads& operator=(const StaticQuads&) = delete;
+
+		StaticQuads& operator=(StaticQuads&& other) noexcept;
+
+		~StaticQuads() { release(); }
+
+		void release();
+
+		std::size_t size() const { return m_quads; }
+
+	private:
+		friend class Renderer;
+
+		unsigned int m_vao{0};
+		unsigned int m_vbo{0};
+		std::size_t  m_quads{0};
+		std::size_t  m_capacity{0};	// bytes the buffer holds
+	};
+
+	/* Simple batch renderer for drawing sprites from the same image and shader.
+	Vertices are streamed to the GPU every frame. Persistent streaming maps one immutable buffer for the renderer's lifetime and hands out
+	pointers straight into it, so quads are written where the GPU reads them without a copy or a reallocation. The buffer is split into
+	REGIONS regions used round robin, one per frame: each is fenced once its draws are submitted and only written again after the GPU
+	passed the fence. Contexts older than 4.4 (no glBufferStorage) fall back to orphaning, batching on the CPU and uploading with
+	glBufferSubData into storage the driver swaps out whenever the GPU still uses the old one.
+	Indexed quads write their 4 corners once and are drawn through an index buffer built at construction for a full batch,
+	instead of 6 vertices per quad with two corners repeated. Instanced quads write a single record per sprite (dest and normalized src,
+	32 bytes) and need a material whose vertex shader expands it into the quad from gl_VertexID (sprite_instanced.vs).
+	With more than one texture slot, materials sharing a shader also share batches: every texture of a batch is bound to a texture unit
+	of its own and quads carry their texture's slot, which the fragment shader (sprite_batch.fs) samples from. A batch is only flushed
+	for another shader or once every slot is taken, instead of on every material switch.
+	Geometry that rarely changes can skip streaming: StaticQuads are written like batches, uploaded once and drawn with a view matrix,
+	so they stay in world space and cost no upload per frame. Batched quads are drawn with an identity view */
 	class Renderer final : public IComponent
 	{
 	public:
+		enum class Streaming
+		{
+			Persistent,
+			Orphan
+		};
+
+		enum class QuadMode
+		{
+			Triangles,	// 6 vertices per quad, drawn with glDrawArrays
+			Indexed,	// 4 vertices per quad, drawn with glDrawElements
+			Instanced	// 1 instance per quad, drawn with glDrawArraysInstanced
+		};
+
+		static constexpr std::size_t REGIONS = 3u;	// frames the CPU may run ahead of the GPU with persistent streaming
+
+		static constexpr std::size_t TRIANGLE_QUAD_FLOATS = 24u;	// 6 vertices of 2 position and 2 texture coordinate floats
+		static constexpr std::size_t INDEXED_QUAD_FLOATS  = 16u;	// 4 vertices of 2 position and 2 texture coordinate floats
+		static constexpr std::array<unsigned int, 6> QUAD_INDICES{ 0u, 1u, 2u, 0u, 3u, 1u };	// writeCorners' corners as writeTriangles' two triangles
+		static constexpr std::size_t INSTANCED_QUAD_FLOATS = 8u;	// dest and normalized src rects
 
-		Renderer(const std::vector<unsigned int>& attributes, unsigned int maxSprites);
+		static constexpr unsigned int MAX_TEXTURE_SLOTS = 8u;	// size of the sampler array in sprite_batch.fs
+
+		// attributes are the float counts of one vertex's attributes, instanced renderers use their fixed instance layout instead
+		Renderer(const std::vector<unsigned int>& attributes,
+				 unsigned int                     maxSprites,
+				 QuadMode                         quadMode     = QuadMode::Indexed,
+				 Streaming                        streaming    = Streaming::Persistent,
+				 unsigned int                     textureSlots = 1u);
 
 		Renderer(const Renderer&) = delete;
 
@@ -32,6 +104,81 @@ namespace Component
 
 		void draw(const Rect& src, const Rect& dest, Component::Material& mat);
 
+		// Makes room for count quads drawn with mat and returns where to write their vertices (see writeQuad), for systems emitting many quads in one pass
+		float* reserveQuads(std::size_t count, Component::Material& mat);
+
+		// Writes a quad the way this renderer draws them, src already normalized to the image dimensions
+		float* writeQuad(float* out, const Rect& dest, const Rect& normSrc) const
+		{
+			return m_textureSlots > 1u ? writeQuadAs<true>(out, dest, normSrc, m_slot) : writeQuadAs<false>(out, dest, normSrc, m_slot);
+		}
+
+		// Writes a quad for upload to StaticQuads, which always sample their material's texture from slot 0
+		float* writeStaticQuad(float* out, const Rect& dest, const Rect& normSrc) const
+		{
+			return m_textureSlots > 1u ? writeQuadAs<true>(out, dest, normSrc, 0.f) : writeQuadAs<false>(out, dest, normSrc, 0.f);
+		}
+
+		// Replaces the quads of quads with vertices, written with writeStaticQuad
+		void upload(StaticQuads& quads, const std::vector<float>& vertices);
+
+		// Draws quads with mat, view placing them relative to the camera. Whatever was batched so far is drawn first
+		void drawStatic(const StaticQuads& quads, Component::Material& mat, const glm::mat4& view);
+
+		// Writes the two triangles of a quad, every vertex followed by slot when SLOTTED
+		template <bool SLOTTED = false>
+		static float* writeTriangles(float* out, const Rect& dest, const Rect& normSrc, const float slot = 0.f)
+		{
+			// First triangle
+			out = writeVertex<SLOTTED>(out, dest.x, dest.y + dest.h, normSrc.x, normSrc.y + normSrc.h, slot);						// Bottom Left
+			out = writeVertex<SLOTTED>(out, dest.x + dest.w, dest.y, normSrc.x + normSrc.w, normSrc.y, slot);						// Top Right
+			out = writeVertex<SLOTTED>(out, dest.x, dest.y, normSrc.x, normSrc.y, slot);											// Top Left
+
+			// Second Triangle
+			out = writeVertex<SLOTTED>(out, dest.x, dest.y + dest.h, normSrc.x, normSrc.y + normSrc.h, slot);						// Bottom Left
+			out = writeVertex<SLOTTED>(out, dest.x + dest.w, dest.y + dest.h, normSrc.x + normSrc.w, normSrc.y + normSrc.h, slot);	// Bottom Right
+			return writeVertex<SLOTTED>(out, dest.x + dest.w, dest.y, normSrc.x + normSrc.w, normSrc.y, slot);					// Top Right
+		}
+
+		// Writes the four corners of a quad in the order the index buffer expects (the same two triangles as writeTriangles)
+		template <bool SLOTTED = false>
+		static float* writeCorners(float* out, const Rect& dest, const Rect& normSrc, const float slot = 0.f)
+		{
+			out = writeVertex<SLOTTED>(out, dest.x, dest.y + dest.h, normSrc.x, normSrc.y + normSrc.h, slot);						// Bottom Left
+			out = writeVertex<SLOTTED>(out, dest.x + dest.w, dest.y, normSrc.x + normSrc.w, normSrc.y, slot);						// Top Right
+			out = writeVertex<SLOTTED>(out, dest.x, dest.y, normSrc.x, normSrc.y, slot);											// Top Left
+			return writeVertex<SLOTTED>(out, dest.x + dest.w, dest.y + dest.h, normSrc.x + normSrc.w, normSrc.y + normSrc.h, slot);	// Bottom Right
+		}
+
+		// Writes the instance record of a quad
+		template <bool SLOTTED = false>
+		static float* writeInstance(float* out, const Rect& dest, const Rect& normSrc, const float slot = 0.f)
+		{
+			out[0] = dest.x;
+			out[1] = dest.y;
+			out[2] = dest.w;
+			out[3] = dest.h;
+			return writeVertex<SLOTTED>(out + 4, normSrc.x, normSrc.y, normSrc.w, normSrc.h, slot);
+		}
+
+		QuadMode quadMode() const { return m_quadMode; }
+
+		// Floats writeQuad writes per quad
+		std::size_t quadFloats() const { return m_quadFloats; }
+
+		// Quads one batch holds, the most reserveQuads hands out at once
+		std::size_t batchQuads() const { return m_batchLimit / m_quadFloats; }
+
+		// Textures one batch can hold
+		unsigned int textureSlots() const { return m_textureSlots; }
+
+		// Draw calls made during the last displayed frame
+		std::size_t drawCalls() const { return m_frameDrawCalls; }
+
+		// Bytes of vertices sent to the GPU during the last displayed frame, streamed batches and static uploads
+		std::size_t uploadedBytes() const { return m_frameUploadedBytes; }
+
+		// Draws whatever is left and ends the frame
 		void display();
 
 		// For batch renderer
@@ -39,15 +186,89 @@ namespace Component
 
 		void endDraw();
 
+		// Streaming actually used, Orphan if persistent mapping isn't supported by the context
+		Streaming streaming() const { return m_mapped ? Streaming::Persistent : Streaming::Orphan; }
+
 	private:
 		void flush();
 
+		// Uploads (when orphaning) and draws the current batch with whatever material is bound, then starts the next batch
+		void submit();
+
+		// Draws the quads written to the floats vertex floats from vertex (instance when instanced) first on
+		void drawQuads(std::size_t first, std::size_t floats);
+
+		// Whether quads drawn with mat can join the current batch's textures and shader
+		bool batches(const Component::Material& mat) const;
+
+		// Slot of texture in the current batch, taking a free one if it has none yet
+		unsigned int slotOf(Component::Texture& texture);
+
+		// Points the bound vao's attributes at the bound array buffer
+		void setAttributes() const;
+
+		// Uses mat's shader with its texture bound for slot 0, for draws outside of a batch
+		void bindStatic(Component::Material& mat) const;
+
+		template <bool SLOTTED>
+		float* writeQuadAs(float* out, const Rect& dest, const Rect& normSrc, const float slot) const
+		{
+			switch (m_quadMode) {
+				case QuadMode::Indexed: return writeCorners<SLOTTED>(out, dest, normSrc, slot);
+				case QuadMode::Instanced: return writeInstance<SLOTTED>(out, dest, normSrc, slot);
+				default: return writeTriangles<SLOTTED>(out, dest, normSrc, slot);
+			}
+		}
+
+		// Writes 4 floats, then slot when SLOTTED
+		template <bool SLOTTED>
+		static float* writeVertex(float* out, const float x, const float y, const float u, const float v, const float slot)
+		{
+			out[0] = x;
+			out[1] = y;
+			out[2] = u;
+			out[3] = v;
+			if constexpr (SLOTTED) {
+				out[4] = slot;
+				return out + 5;
+			}
+			return out + 4;
+		}
+
+		// Floats in the current batch
+		std::size_t pending() const;
+
+		// Fences the region written so far and waits until the GPU is done with the next one (persistent streaming only)
+		void nextRegion();
+
 	private:
 		unsigned int               m_vbo{0};
 		unsigned int               m_vao{0};
-		unsigned int               m_attribSize{};
+		unsigned int               m_ibo{0};
+		QuadMode                   m_quadMode{QuadMode::Indexed};
+		std::size_t                m_quadFloats{TRIANGLE_QUAD_FLOATS};
+		std::vector<unsigned int>  m_layout{};					// float counts of the attributes
+		unsigned int               m_attribSize{};				// floats per vertex, per instance when instanced
 		unsigned int               m_maxSprites{};
-		std::vector<float> m_buffer{};
+		std::size_t                m_batchLimit{0};			// floats a batch is flushed at, also the size of one buffer region
+		std::vector<float> m_buffer{};					// batch being built when orphaning
 		Component::Material*            m_currentMaterial{nullptr};
+		std::size_t                m_drawCalls{0};
+		std::size_t                m_frameDrawCalls{0};
+		std::size_t                m_uploadedBytes{0};
+		std::size_t                m_frameUploadedBytes{0};
+
+		// Texture slots
+		unsigned int                                           m_textureSlots{1};
+		std::array<Component::Texture*, MAX_TEXTURE_SLOTS>     m_slotTextures{};	// texture bound to each slot of the current batch
+		unsigned int                                           m_slotsUsed{0};
+		float                                                  m_slot{0.f};			// slot the quads being written sample from
+
+		// Persistent streaming
+		float*                         m_mapped{nullptr};	// the whole buffer, mapped for the renderer's lifetime
+		std::array<GLsync, REGIONS>    m_fences{};
+		std::size_t                    m_region{0};
+		std::size_t                    m_batchStart{0};		// float offsets of the current batch inside the buffer
+		std::size_t                    m_batchEnd{0};
 	};
 }
@@ -141,6 +141,11 @@ namespace Component
 		glUniform1i(glGetUniformLocation(m_id, name), value);
 	}
 
+	void Component::Shader::setIntArray(const GLchar* name, const GLint* values, const GLsizei count)
+	{
+		glUniform1iv(glGetUniformLocation(m_id, name), count, values);
+	}
+
 	void Component::Shader::setFloat(const GLchar* name, const GLfloat value)
 	{
 		glUniform1f(glGetUniformLocation(m_id, name), value);
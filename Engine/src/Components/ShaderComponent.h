@@ -40,6 +40,7 @@ namespace Component
 		// Uniform sets
 		void setBool(const GLchar* name, GLboolean value);
 		void setInt(const GLchar* name,  GLint value);
+		void setIntArray(const GLchar* name, const GLint* values, GLsizei count);
 		void setFloat(const GLchar* name, GLfloat value);
 
 		void setVec2f(const GLchar* name, const glm::vec2& value);
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Components/BaseComponent.h"
+#include "EntityHandle.h"
 
 namespace Component
 {
@@ -9,4 +10,11 @@ namespace Component
 	public:
 		virtual void execute() = 0;
 	};
+
+	/* System paired with the registry entity that owns it, so loops can skip systems of destroyed or inactive entities without touching them */
+	struct OwnedSystem
+	{
+		EntityHandle owner;
+		ISystem*     system;
+	};
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include "TextureComponent.h"
 
-#define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 #include <iostream>
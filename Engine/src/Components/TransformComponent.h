@@ -10,7 +10,7 @@ namespace Component
 	{
 	public:
 		Transform(const Rect& rect, const float scale)
-			: Rect(rect), scale(scale)
+			: Rect(rect), scale(scale), prevX(rect.x), prevY(rect.y)
 		{
 		}
 
@@ -29,7 +29,22 @@ namespace Component
 		{
 		}
 
+		// Remembers the current position as the one of the previous simulation tick, call before every tick
+		void snapshot()
+		{
+			prevX = x;
+			prevY = y;
+		}
+
+		// Position blended between the previous and current tick, alpha = 0 is the previous tick and alpha = 1 the current one
+		Rect lerp(const float alpha) const
+		{
+			return Rect{ prevX + (x - prevX) * alpha, prevY + (y - prevY) * alpha, w, h };
+		}
+
 		float scale;
+		float prevX;
+		float prevY;
 	};
 }
 
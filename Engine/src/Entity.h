@@ -1,18 +1,39 @@
 #pragma once
+#include "Archetype.h"
+#include "FlatMap.h"
 #include "Logger.h"
 #include "SplayTree.h"
+#include "StringID.h"
 #include "Components/BaseComponent.h"
 
 #include <array>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
 
 using ComponentID = std::size_t;
 
+// Entities keep their components and children in flat sorted arrays whose lookups never write to memory.
+// Define ENTITY_SPLAY_STORAGE to go back to self-adjusting splay trees instead.
+#ifdef ENTITY_SPLAY_STORAGE
+template <typename T>
+using EntityStorage = SplayTree<T>;
+#else
+template <typename T>
+using EntityStorage = FlatMap<T>;
+#endif
+
+// Component casts are verified in Debug builds and become plain static_casts in Release/Dist.
+// Define ENTITY_UNCHECKED_CASTS to skip the checks in Debug as well.
+#if defined(_DEBUG) && !defined(ENTITY_UNCHECKED_CASTS)
+#define ENTITY_CHECKED_CASTS
+#endif
+
 /////////////////////////////////////////////////////////
 //  Helper Functions
 /////////////////////////////////////////////////////////
@@ -36,11 +57,77 @@ inline ComponentID getComponentTypeID() noexcept
 
 /////////////////////////////////////////////////////////
 
+/* Told when components of an entity it owns are added or removed, so an owner caching component pointers (EntityRegistry views) sees
+every component however it was added and never keeps a deleted one */
+class EntityOwner
+{
+public:
+	virtual ~EntityOwner() = default;
+
+	// Only reported for components stored under their type's key, the ones getComponent<T>() finds
+	virtual void onComponentAdded(std::uint32_t slot, ComponentID type) = 0;
+	virtual void onComponentRemoved(std::uint32_t slot, ComponentID type) = 0;
+	virtual void onComponentsCleared(std::uint32_t slot) = 0;
+};
+
 /* Storage class for components and other entities beneath it can either id and retrieve components/children, or treat them as lists. */
 class Entity
 {
 public:
 	static long long count; // count entity references
+
+	/* Key ordered view over one of the entity's trees handing out T&. Component ranges only visit components stored as exactly T
+	(or every component for T = IComponent). Walking it never allocates, so it's safe to use in per frame traversal */
+	template <typename T, typename Storage>
+	class Range
+	{
+	public:
+		class Iterator
+		{
+		public:
+			Iterator(typename Storage::Iterator it, typename Storage::Iterator end)
+				: m_it(it), m_end(end)
+			{
+				skip();
+			}
+
+			T& operator*() const { return *static_cast<T*>(*m_it); }
+
+			Iterator& operator++()
+			{
+				++m_it;
+				skip();
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const { return m_it == other.m_it; }
+			bool operator!=(const Iterator& other) const { return m_it != other.m_it; }
+
+		private:
+			// Steps over components of other types using the type tag stored with them
+			void skip()
+			{
+				if constexpr (std::is_base_of_v<IComponent, T> && !std::is_same_v<IComponent, T>)
+					while (m_it != m_end && m_it.tag() != getComponentTypeID<T>())
+						++m_it;
+			}
+
+			typename Storage::Iterator m_it;
+			typename Storage::Iterator m_end;
+		};
+
+		explicit Range(const Storage& storage)
+			: m_storage(storage)
+		{
+		}
+
+		Iterator begin() const { return Iterator(m_storage.begin(), m_storage.end()); }
+		Iterator end() const { return Iterator(m_storage.end(), m_storage.end()); }
+
+	private:
+		const Storage& m_storage;
+	};
+
 public:
 	Entity()
 	{
@@ -50,8 +137,8 @@ public:
 	~Entity()
 	{
 		--count;
-		m_components.~SplayTree();
-		m_children.~SplayTree();
+		m_components.clear();
+		m_children.clear();
 	}
 
 	// delete all functions that could possibly copy one entity onto another
@@ -70,13 +157,12 @@ public:
 		return rChild;
 	}
 
-	Entity* getChild(const std::string& id)
+	Entity* getChild(const StringID id)
 	{
-		const auto hashed_str = std::hash<std::string>{}(id);
-		const auto rChild    = m_children.search(hashed_str);
+		const auto rChild = m_children.search(id.value());
 
 		if (!rChild)
-			Logger::error("Could not find child at string id = " + id, Logger::SEVERITY::HIGH);
+			Logger::error("Could not find child at string id = " + id.toString(), Logger::SEVERITY::HIGH);
 
 		return rChild;
 	}
@@ -86,16 +172,27 @@ public:
 		return m_children.getOrderedList();
 	}
 
-	bool hasChild(const std::string& id)
+	// Range over the children in key order, for (auto& child : entity->children())
+	Range<Entity, EntityStorage<Entity>> children() const
 	{
-		const auto hashedStr = std::hash<std::string>{}(id);
-		return m_children.search(hashedStr);
+		return Range<Entity, EntityStorage<Entity>>(m_children);
 	}
 
-	void removeChild(const std::string& id)
+	// Calls fn(Entity&) for every child in key order without allocating
+	template <typename Fn>
+	void forEachChild(Fn&& fn) const
 	{
-		const auto hashedStr = std::hash<std::string>{}(id);
-		m_children.remove(hashedStr);
+		m_children.forEach([&fn](Entity* child) { fn(*child); });
+	}
+
+	bool hasChild(const StringID id)
+	{
+		return m_children.search(id.value());
+	}
+
+	void removeChild(const StringID id)
+	{
+		m_children.remove(id.value());
 	}
 
 	std::size_t childrenSize()
@@ -110,23 +207,23 @@ public:
 	}
 
 	// Inserts entity into child tree with hash of str as unique id
-	Entity* add_child(Entity* entity, const std::string& id)
+	Entity* add_child(Entity* entity, const StringID id)
 	{
-		return m_children.insert(std::hash<std::string>{}(id), entity);
+		id.registerName();
+		return m_children.insert(id.value(), entity);
 	}
 
 	// Inserts entity into child tree with hash of string as unique id
-	Entity* addIDChild(Entity* entity, const std::string& id)
+	Entity* addIDChild(Entity* entity, const StringID id)
 	{
-		const auto hashedStr = std::hash<std::string>{}(id);
-		return m_children.insert(hashedStr, entity);
+		id.registerName();
+		return m_children.insert(id.value(), entity);
 	}
 
-	Entity* addIDChild(const std::string& id)
+	Entity* addIDChild(const StringID id)
 	{
-		const auto       entity         = new Entity();
-		const auto hashedStr = std::hash<std::string>{}(id);
-		return m_children.insert(hashedStr, entity);
+		id.registerName();
+		return m_children.insert(id.value(), new Entity());
 	}
 
 	// Inserts entity into child tree with unique id
@@ -144,12 +241,12 @@ public:
 		if (!rComp)
 			Logger::error("Could not find component, component id = " + std::to_string(getComponentTypeID<T>()), Logger::SEVERITY::HIGH);
 
-		auto casted_r_comp = dynamic_cast<T*>(rComp);
-
-		if (!casted_r_comp)
+#ifdef ENTITY_CHECKED_CASTS
+		if (!isComponentOf<T>(getComponentTypeID<T>(), rComp))
 			Logger::error("Component not of casted type", Logger::SEVERITY::HIGH);
+#endif
 
-		return casted_r_comp;
+		return static_cast<T*>(rComp);
 	}
 
 	// Searches component tree for templated component at pos
@@ -161,31 +258,29 @@ public:
 		if (!rBaseComponent)
 			Logger::error("Could not find component, position = " + std::to_string(position), Logger::SEVERITY::HIGH);
 
-		auto castedRComp = dynamic_cast<T*>(rBaseComponent);
-
-		if (!castedRComp)
+#ifdef ENTITY_CHECKED_CASTS
+		if (!isComponentOf<T>(position, rBaseComponent))
 			Logger::error("Component not of casted type, position = " + std::to_string(position), Logger::SEVERITY::HIGH);
+#endif
 
-		return castedRComp;
+		return static_cast<T*>(rBaseComponent);
 	}
 
 	// Searches component tree for specific component of hashed string
 	template <typename T>
-	T* get_component(const std::string id)
+	T* get_component(const StringID id)
 	{
-		const auto hashedStr = std::hash<std::string>{}(id);
-		auto rComp = m_components.search(hashedStr);
+		auto rComp = m_components.search(id.value());
 
 		if (!rComp)
-			Logger::error("could not find component, str id = " + id, Logger::SEVERITY::HIGH);
-
-		auto castedRComp = dynamic_cast<T*>(rComp);
+			Logger::error("could not find component, str id = " + id.toString(), Logger::SEVERITY::HIGH);
 
-		if (!castedRComp)
-			Logger::error("component not of casted type, str id = " + id, Logger::SEVERITY::HIGH);
+#ifdef ENTITY_CHECKED_CASTS
+		if (!isComponentOf<T>(id.value(), rComp))
+			Logger::error("component not of casted type, str id = " + id.toString(), Logger::SEVERITY::HIGH);
+#endif
 
-
-		return castedRComp;
+		return static_cast<T*>(rComp);
 	}
 
 
@@ -197,10 +292,9 @@ public:
 	}
 
 	// Checks if string id of component is located in component tree
-	template <typename T> bool hasComponent(const std::string id)
+	template <typename T> bool hasComponent(const StringID id)
 	{
-		const auto hashedStr = std::hash<std::string>{}(id);
-		return m_components.search(hashedStr);
+		return m_components.search(id.value());
 	}
 
 	// Checks if id of component is located in component tree
@@ -214,17 +308,20 @@ public:
 	T* addComponent(TArgs&&...args)
 	{
 		T* comp(new T(std::forward<TArgs>(args)...));
-		return static_cast<T*>(m_components.insert(getComponentTypeID<T>(), comp));
+		const auto added = static_cast<T*>(m_components.insert(getComponentTypeID<T>(), comp, getComponentTypeID<T>()));
+		notifyAdded(getComponentTypeID<T>());
+		return added;
 	}
 
 	// Adds component to splay tree using a hashed string
 	template<typename T, typename... TArgs>
-	T* addIDComponent(const std::string id, TArgs&&...args)
+	T* addIDComponent(const StringID id, TArgs&&...args)
 	{
-		static_assert (std::is_base_of_v<IComponent, T>, "addIDComponent(std::string) T not a component");
+		static_assert (std::is_base_of_v<IComponent, T>, "addIDComponent(StringID) T not a component");
 		T* component(new T(std::forward<TArgs>(args)...));
-		auto hashedStr = std::hash<std::string>{}(id);
-		m_components.insert(hashedStr, component);
+		id.registerName();
+		m_components.insert(id.value(), component, getComponentTypeID<T>());
+		notifyAdded(getComponentTypeID<T>());
 		return component;
 	}
 
@@ -234,7 +331,8 @@ public:
 	{
 		static_assert (std::is_base_of_v<IComponent, T>, "addIDComponent(std::size_t) T not a component");
 		T* c(new T(std::forward<TArgs>(args)...));
-		m_components.insert(id, c);
+		m_components.insert(id, c, getComponentTypeID<T>());
+		notifyAdded(getComponentTypeID<T>());
 		return c;
 	}
 
@@ -244,19 +342,66 @@ public:
 	{
 		static_assert (std::is_base_of_v<IComponent, T>, "push_back() not a component");
 		T* c(new T(std::forward<TArgs>(args)...));
-		return static_cast<T*>(m_components.insert(c));
+		const auto added = static_cast<T*>(m_components.insert(c, getComponentTypeID<T>()));
+		notifyAdded(getComponentTypeID<T>());
+		return added;
+	}
+
+	// Deletes the component added with addComponent<T>(), does nothing if there isn't one
+	template <typename T>
+	void removeComponent()
+	{
+		if (m_owner && hasComponent<T>())
+			m_owner->onComponentRemoved(m_slot, getComponentTypeID<T>());
+		m_components.remove(getComponentTypeID<T>());
 	}
 
-	// Gets the array of components
+	// Makes room for count components in total, so bulk push_backs don't regrow the component tree
+	void reserve(const std::size_t count)
+	{
+		m_components.reserve(count);
+	}
+
+	// Pushes back count sets of Ts components in one go. init(i) returns a tuple with one constructor argument per component
+	// (a tuple for several arguments). Component pools and the component tree are sized once up front
+	template <typename... Ts, typename Fn>
+	void createMany(const std::size_t count, Fn&& init)
+	{
+		static_assert((std::is_base_of_v<IComponent, Ts> && ...), "createMany() Ts not all components");
+
+		ComponentAllocator::reserve<Ts...>(count);
+		reserve(m_components.size() + count * sizeof...(Ts));
+
+		for (std::size_t i = 0; i < count; ++i)
+			std::apply([this](auto&&... args) { (pushBackFrom<Ts>(std::forward<decltype(args)>(args)), ...); }, init(i));
+	}
+
+	// Gets the array of components stored as T in key order, components of other types are skipped by their type tag
 	template<typename T>
-	std::vector<IComponent*> getComponentList()
+	std::vector<T*> getComponentList()
 	{
 		std::vector<T*> tcompList;
-		for (auto comp : m_components.getOrderedList())
-			tcompList.push_back(dynamic_cast<T*>(comp));
+		for (auto& comp : components<T>())
+			tcompList.push_back(&comp);
 		return tcompList;
 	}
 
+	// Range over the components stored as T in key order (every component for T = IComponent), for (auto& src : entity->components<Component::Src>())
+	template <typename T>
+	Range<T, EntityStorage<IComponent>> components() const
+	{
+		static_assert(std::is_base_of_v<IComponent, T>, "components<T>() T not a component");
+		return Range<T, EntityStorage<IComponent>>(m_components);
+	}
+
+	// Calls fn(T&) for every component stored as T in key order without allocating
+	template <typename T, typename Fn>
+	void forEachComponent(Fn&& fn) const
+	{
+		for (auto& component : components<T>())
+			fn(component);
+	}
+
 	std::size_t componentsSize()
 	{
 		return m_components.size();
@@ -265,10 +410,19 @@ public:
 	// Delete all components and children
 	void clear()
 	{
+		if (m_owner)
+			m_owner->onComponentsCleared(m_slot);
 		m_children.clear();
 		m_components.clear();
 	}
 
+	// Set by the owner of a top level entity (EntityRegistry::create) so it hears about components added or removed straight through the entity
+	void setOwner(EntityOwner* owner, const std::uint32_t slot)
+	{
+		m_owner = owner;
+		m_slot  = slot;
+	}
+
 	// Delete all entity children
 	void clearChildren()
 	{
@@ -276,6 +430,34 @@ public:
 	}
 
 private:
-	SplayTree<IComponent> m_components{};
-	SplayTree<Entity>        m_children{};
+	// Tells the owner about a component of type just added, if one of that type now sits under the type's own key
+	void notifyAdded(const ComponentID type)
+	{
+		if (m_owner && m_components.search(type) && m_components.tag(type) == type)
+			m_owner->onComponentAdded(m_slot, type);
+	}
+
+	// push_back<T> taking its constructor arguments from a tuple, or a single argument
+	template <typename T, typename Arg>
+	T* pushBackFrom(Arg&& arg)
+	{
+		if constexpr (ArchetypeDetail::IsTuple<std::decay_t<Arg>>::value)
+			return std::apply([this](auto&&... args) { return push_back<T>(std::forward<decltype(args)>(args)...); }, std::forward<Arg>(arg));
+		else
+			return push_back<T>(std::forward<Arg>(arg));
+	}
+
+#ifdef ENTITY_CHECKED_CASTS
+	// Cheap check against the type tag stored with the component, falls back to RTTI when T is a base of the stored type
+	template <typename T>
+	bool isComponentOf(const std::size_t key, IComponent* component)
+	{
+		return !component || m_components.tag(key) == getComponentTypeID<T>() || dynamic_cast<T*>(component);
+	}
+#endif
+
+	EntityStorage<IComponent> m_components{};
+	EntityStorage<Entity>     m_children{};
+	EntityOwner*              m_owner{nullptr};
+	std::uint32_t             m_slot{0};
 };
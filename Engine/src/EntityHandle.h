@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+/* Generational handle to an entity owned by an EntityRegistry.
+The index picks the registry slot and the generation is bumped every time that slot is recycled, so a handle to a destroyed entity
+never resolves to whatever entity reuses its slot later. A default constructed handle is null. */
+struct EntityHandle
+{
+	static constexpr std::uint32_t NULL_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+	std::uint32_t index{NULL_INDEX};
+	std::uint32_t generation{0u};
+
+	bool isNull() const { return index == NULL_INDEX; }
+
+	// Packs the handle into a single 64 bit value, handy as a map key or for serialization
+	std::uint64_t value() const { return static_cast<std::uint64_t>(generation) << 32 | index; }
+
+	bool operator==(const EntityHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
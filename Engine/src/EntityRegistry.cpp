@@ -0,0 +1,235 @@
+#include "EntityRegistry.h"
+
+#include <algorithm>
+
+EntityRegistry::~EntityRegistry()
+{
+	clear();
+}
+
+EntityHandle EntityRegistry::create()
+{
+	std::uint32_t index;
+
+	if (!m_freeList.empty()) {
+		index = m_freeList.back();
+		m_freeList.pop_back();
+	}
+	else {
+		index = static_cast<std::uint32_t>(m_entities.size());
+		m_entities.push_back(new Entity());
+		m_entities.back()->setOwner(this, index);
+		m_generations.push_back(0u);
+		m_flags.push_back(0u);
+		m_signatures.emplace_back();
+	}
+
+	m_flags[index] = ALIVE | ACTIVE;
+	++m_alive;
+	return EntityHandle{ index, m_generations[index] };
+}
+
+void EntityRegistry::destroy(const EntityHandle handle)
+{
+	if (!isAlive(handle))
+		return;
+
+	// Dead from now on, the entity itself is cleared on flush so systems running this frame can still finish with it
+	m_flags[handle.index] = 0u;
+	onComponentsCleared(handle.index);
+
+	--m_alive;
+	m_pending.push_back(handle);
+}
+
+void EntityRegistry::flush()
+{
+	for (const auto handle : m_pending) {
+		// Entities are kept and cleared rather than deleted so their slot can reuse the allocation
+		m_entities[handle.index]->clear();
+		++m_generations[handle.index];
+		m_freeList.push_back(handle.index);
+	}
+	m_pending.clear();
+}
+
+void EntityRegistry::clear()
+{
+	for (const auto entity : m_entities)
+		delete entity;
+
+	m_entities.clear();
+	m_generations.clear();
+	m_flags.clear();
+	m_signatures.clear();
+	m_freeList.clear();
+	m_pending.clear();
+	m_views.clear();
+	m_scans.clear();
+	m_alive = 0;
+}
+
+Entity* EntityRegistry::get(const EntityHandle handle) const
+{
+	return isAlive(handle) ? m_entities[handle.index] : nullptr;
+}
+
+bool EntityRegistry::isAlive(const EntityHandle handle) const
+{
+	return matches(handle) && m_flags[handle.index] & ALIVE;
+}
+
+bool EntityRegistry::isActive(const EntityHandle handle) const
+{
+	return matches(handle) && m_flags[handle.index] == (ALIVE | ACTIVE);
+}
+
+void EntityRegistry::setActive(const EntityHandle handle, const bool active)
+{
+	if (!isAlive(handle))
+		return;
+
+	if (active)
+		m_flags[handle.index] |= ACTIVE;
+	else
+		m_flags[handle.index] &= static_cast<std::uint8_t>(~ACTIVE);
+}
+
+bool EntityRegistry::shouldUpdate(const EntityHandle handle) const
+{
+	return handle.isNull() || isActive(handle);
+}
+
+std::size_t EntityRegistry::size() const
+{
+	return m_alive;
+}
+
+bool EntityRegistry::matches(const EntityHandle handle) const
+{
+	return handle.index < m_generations.size() && m_generations[handle.index] == handle.generation;
+}
+
+EntityRegistry::ViewCache& EntityRegistry::cacheFor(const Signature& mask)
+{
+	for (const auto& view : m_views)
+		if (view->mask == mask)
+			return *view;
+
+	auto& view = *m_views.emplace_back(std::make_unique<ViewCache>());
+	view.mask = mask;
+	for (ComponentID type = 0; type < MAX_COMPONENT_TYPES; ++type)
+		if (mask.test(type))
+			view.types.push_back(type);
+
+	// First time this view is asked for, every later change keeps it up to date
+	for (std::uint32_t i = 0; i < m_signatures.size(); ++i)
+		if (m_flags[i] & ALIVE && (m_signatures[i] & mask) == mask)
+			addToView(view, i);
+
+	return view;
+}
+
+EntityRegistry::ViewCache& EntityRegistry::scanFor(std::vector<ComponentID> types)
+{
+	std::sort(types.begin(), types.end());
+
+	ViewCache* found = nullptr;
+	for (const auto& scan : m_scans)
+		if (scan->types == types)
+			found = scan.get();
+
+	if (!found) {
+		found = m_scans.emplace_back(std::make_unique<ViewCache>()).get();
+		found->types = std::move(types);
+	}
+
+	// Untracked types have no signature bit to keep the match set up to date with, so it is rebuilt from the entities every time
+	auto& scan = *found;
+	scan.entities.clear();
+	scan.components.clear();
+	for (std::uint32_t i = 0; i < m_entities.size(); ++i) {
+		const auto entity = m_entities[i];
+		if (!(m_flags[i] & ALIVE) || !std::all_of(scan.types.begin(), scan.types.end(), [entity](const ComponentID type) { return entity->has_component<IComponent>(type); }))
+			continue;
+
+		scan.entities.push_back(i);
+		for (const auto type : scan.types)
+			scan.components.push_back(entity->getComponent<IComponent>(static_cast<int>(type)));
+	}
+
+	return scan;
+}
+
+void EntityRegistry::addToView(ViewCache& view, const std::uint32_t index)
+{
+	if (view.positions.size() <= index)
+		view.positions.resize(m_entities.size(), 0u);
+	if (view.positions[index])
+		return;
+
+	const auto entity = m_entities[index];
+	view.entities.push_back(index);
+	for (const auto type : view.types)
+		view.components.push_back(entity->getComponent<IComponent>(static_cast<int>(type)));
+	view.positions[index] = static_cast<std::uint32_t>(view.entities.size());
+}
+
+void EntityRegistry::removeFromView(ViewCache& view, const std::uint32_t index)
+{
+	if (view.positions.size() <= index || !view.positions[index])
+		return;
+
+	// Swap the last match into the hole so the match set stays packed
+	const auto position = view.positions[index] - 1;
+	const auto last = view.entities.size() - 1;
+	const auto stride = view.types.size();
+
+	if (position != last) {
+		const auto moved = view.entities[last];
+		view.entities[position] = moved;
+		std::copy_n(view.components.begin() + last * stride, stride, view.components.begin() + position * stride);
+		view.positions[moved] = position + 1;
+	}
+
+	view.entities.pop_back();
+	view.components.resize(last * stride);
+	view.positions[index] = 0u;
+}
+
+void EntityRegistry::onComponentAdded(const std::uint32_t index, const ComponentID type)
+{
+	// Untracked types have no signature bit, views over them scan the entities when asked for. Destroyed entities stay out of views
+	if (type >= MAX_COMPONENT_TYPES || !(m_flags[index] & ALIVE))
+		return;
+
+	auto& signature = m_signatures[index];
+	if (signature.test(type))
+		return;
+
+	signature.set(type);
+	for (const auto& view : m_views)
+		if (view->mask.test(type) && (signature & view->mask) == view->mask)
+			addToView(*view, index);
+}
+
+void EntityRegistry::onComponentRemoved(const std::uint32_t index, const ComponentID type)
+{
+	// Untracked types are never in a cached view, scanned views are rebuilt when asked for
+	if (type >= MAX_COMPONENT_TYPES)
+		return;
+
+	for (const auto& view : m_views)
+		if (view->mask.test(type))
+			removeFromView(*view, index);
+
+	m_signatures[index].reset(type);
+}
+
+void EntityRegistry::onComponentsCleared(const std::uint32_t index)
+{
+	for (const auto& view : m_views)
+		removeFromView(*view, index);
+
+	m_signatures[index].reset();
+}
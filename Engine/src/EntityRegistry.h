@@ -0,0 +1,220 @@
+#pragma once
+#include "Entity.h"
+#include "EntityHandle.h"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifndef REGISTRY_MAX_COMPONENT_TYPES
+#define REGISTRY_MAX_COMPONENT_TYPES 64
+#endif
+
+/*
+Owns top level entities and hands out generational handles to them.
+Slots of destroyed entities are recycled through a free list, so create() and destroy() are O(1).
+Destruction is deferred: destroy() only flags the entity as dead (systems stop seeing it immediately) and flush(), called at the end of the frame,
+clears it and recycles its slot. Alive/active state is kept in a flat array next to the generations, so loops can skip dead or inactive
+entities without touching the entities or their components.
+
+Components added through the registry are also tracked in a per entity signature, which drives typed views: view<Transform, Src>()
+iterates every entity holding all of those components. Each view's match set (entity slots plus cached component pointers) is built once
+and kept up to date incrementally as components are added or removed and entities destroyed. Registry entities report components added
+or removed straight through Entity (addComponent, push_back, removeComponent, clear...) as well (see EntityOwner), so views see every
+component however it was added and never hold a pointer to a deleted one.
+Signatures hold MAX_COMPONENT_TYPES bits (REGISTRY_MAX_COMPONENT_TYPES, 64 unless defined otherwise). Component types past the cap still work,
+they just aren't tracked, so views over them fall back to scanning every entity each time they are asked for.
+*/
+class EntityRegistry final : public EntityOwner
+{
+public:
+	static constexpr std::size_t MAX_COMPONENT_TYPES = REGISTRY_MAX_COMPONENT_TYPES;
+
+	using Signature = std::bitset<MAX_COMPONENT_TYPES>;
+
+private:
+	/* Cached set of entities matching a signature, with their matching components stored in ascending ComponentID order */
+	struct ViewCache
+	{
+		Signature                  mask{};
+		std::vector<ComponentID>   types{};
+		std::vector<std::uint32_t> entities{};
+		std::vector<IComponent*>   components{};	// types.size() pointers per entity
+		std::vector<std::uint32_t> positions{};		// slot index -> position in entities + 1, 0 when not in the view
+	};
+
+public:
+	/* Typed view over every entity holding all of Ts, iterating the cached match set linearly */
+	template <typename... Ts>
+	class View
+	{
+	public:
+		View(const EntityRegistry& registry, const ViewCache& cache)
+			: m_registry(registry), m_cache(cache)
+		{
+			// Where each T sits among the cached pointers of an entity
+			std::size_t i = 0;
+			((m_offsets[i++] = rank(getComponentTypeID<Ts>())), ...);
+		}
+
+		// Calls fn(Ts&...) or fn(EntityHandle, Ts&...) for every active matching entity
+		template <typename Fn>
+		void each(Fn&& fn) const
+		{
+			const auto stride = m_cache.types.size();
+			for (std::size_t i = 0; i < m_cache.entities.size(); ++i) {
+				const auto index = m_cache.entities[i];
+				if (m_registry.m_flags[index] != (ALIVE | ACTIVE))
+					continue;
+
+				const auto row = m_cache.components.data() + i * stride;
+				call(fn, index, row, std::index_sequence_for<Ts...>{});
+			}
+		}
+
+		// Number of matching entities, including inactive ones
+		std::size_t size() const
+		{
+			return m_cache.entities.size();
+		}
+
+	private:
+		std::size_t rank(const ComponentID id) const
+		{
+			std::size_t result = 0;
+			for (const auto type : m_cache.types)
+				if (type < id)
+					++result;
+			return result;
+		}
+
+		template <typename Fn, std::size_t... Is>
+		void call(Fn& fn, const std::uint32_t index, IComponent* const* row, std::index_sequence<Is...>) const
+		{
+			if constexpr (std::is_invocable_v<Fn&, EntityHandle, Ts&...>)
+				fn(EntityHandle{ index, m_registry.m_generations[index] }, *static_cast<Ts*>(row[m_offsets[Is]])...);
+			else
+				fn(*static_cast<Ts*>(row[m_offsets[Is]])...);
+		}
+
+		const EntityRegistry&                  m_registry;
+		const ViewCache&                       m_cache;
+		std::array<std::size_t, sizeof...(Ts)> m_offsets{};
+	};
+
+	EntityRegistry() = default;
+	~EntityRegistry();
+
+	EntityRegistry(const EntityRegistry&) = delete;
+	EntityRegistry(EntityRegistry&&) = delete;
+	EntityRegistry& operator=(const EntityRegistry&) = delete;
+	EntityRegistry& operator=(EntityRegistry&&) = delete;
+
+	// Creates a new active entity, reusing a free slot if there is one
+	EntityHandle create();
+
+	// Flags the entity as destroyed, it is cleared and its slot recycled on the next flush()
+	void destroy(EntityHandle handle);
+
+	// Clears every entity destroyed since the last flush and recycles their slots, call once at the end of a frame
+	void flush();
+
+	// Deletes every entity and resets the registry
+	void clear();
+
+	// Gets the entity of handle, nullptr if the handle is stale or the entity was destroyed
+	Entity* get(EntityHandle handle) const;
+
+	bool isAlive(EntityHandle handle) const;
+	bool isActive(EntityHandle handle) const;
+	void setActive(EntityHandle handle, bool active);
+
+	// True for alive and active entities and for the null handle, which marks systems that aren't owned by a registry entity
+	bool shouldUpdate(EntityHandle handle) const;
+
+	// Calls fn(EntityHandle, Entity&) for every alive and active entity
+	template <typename Fn>
+	void each(Fn&& fn)
+	{
+		for (std::uint32_t i = 0; i < m_flags.size(); ++i)
+			if (m_flags[i] == (ALIVE | ACTIVE))
+				fn(EntityHandle{ i, m_generations[i] }, *m_entities[i]);
+	}
+
+	// Adds a component to the entity (see Entity::addComponent), the entity reports it so the views it now matches pick it up
+	template <typename T, typename... TArgs>
+	T* addComponent(const EntityHandle handle, TArgs&&... args)
+	{
+		const auto entity = get(handle);
+		return entity ? entity->addComponent<T>(std::forward<TArgs>(args)...) : nullptr;
+	}
+
+	// Removes the component from the entity, which drops it from views that needed it first
+	template <typename T>
+	void removeComponent(const EntityHandle handle)
+	{
+		if (const auto entity = get(handle))
+			entity->removeComponent<T>();
+	}
+
+	// Gets the view over every entity holding all of Ts, building its match set the first time it is asked for
+	template <typename... Ts>
+	View<Ts...> view()
+	{
+		static_assert(sizeof...(Ts) > 0, "view needs at least one component type");
+		static_assert((std::is_base_of_v<IComponent, Ts> && ...), "view types must be components");
+
+		if (!(isTracked<Ts>() && ...))
+			return View<Ts...>(*this, scanFor({ getComponentTypeID<Ts>()... }));
+
+		Signature mask;
+		(mask.set(getComponentTypeID<Ts>()), ...);
+		return View<Ts...>(*this, cacheFor(mask));
+	}
+
+	// Number of alive entities
+	std::size_t size() const;
+
+private:
+	enum Flags : std::uint8_t
+	{
+		ALIVE  = 1u << 0,
+		ACTIVE = 1u << 1,
+	};
+
+	// False for component types past MAX_COMPONENT_TYPES, warns once per type
+	template <typename T>
+	static bool isTracked()
+	{
+		const auto id = getComponentTypeID<T>();
+		if (id < MAX_COMPONENT_TYPES)
+			return true;
+
+		static const bool warned = (Logger::warning("Component id " + std::to_string(id) + " doesn't fit in a registry signature, views over it scan every entity (raise REGISTRY_MAX_COMPONENT_TYPES)", Logger::SEVERITY::LOW), true);
+		(void)warned;
+		return false;
+	}
+
+	bool matches(EntityHandle handle) const;
+
+	ViewCache& cacheFor(const Signature& mask);
+	ViewCache& scanFor(std::vector<ComponentID> types);
+	void addToView(ViewCache& view, std::uint32_t index);
+	void removeFromView(ViewCache& view, std::uint32_t index);
+	void onComponentAdded(std::uint32_t index, ComponentID type) override;
+	void onComponentRemoved(std::uint32_t index, ComponentID type) override;
+	void onComponentsCleared(std::uint32_t index) override;
+
+	std::vector<Entity*>                    m_entities{};
+	std::vector<std::uint32_t>              m_generations{};
+	std::vector<std::uint8_t>               m_flags{};
+	std::vector<Signature>                  m_signatures{};
+	std::vector<std::uint32_t>              m_freeList{};
+	std::vector<EntityHandle>               m_pending{};
+	std::vector<std::unique_ptr<ViewCache>> m_views{};
+	std::vector<std::unique_ptr<ViewCache>> m_scans{};	// views over untracked types, rebuilt on every view() call
+	std::size_t                             m_alive{0};
+};
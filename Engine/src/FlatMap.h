@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+/*
+Flat sorted map with the same interface as SplayTree, used as the default storage for entity components and children.
+Keys and values are kept in two parallel sorted arrays, so a lookup never writes to memory: keys handed out by insert(value)
+are checked directly by position, small maps are scanned linearly and larger ones binary searched.
+Reads are O(1) for array-like use and O(log n) otherwise, and can safely run from several threads at once.
+Insertion of an arbitrary key is O(n) but entities are built once and read every frame.
+*/
+template <typename T>
+class FlatMap
+{
+	static constexpr std::size_t LINEAR_SEARCH_SIZE = 16u; // maps this size or smaller are scanned instead of bisected
+
+public:
+	/* Ascending key iterator straight over the flat arrays */
+	class Iterator
+	{
+	public:
+		Iterator(const FlatMap* map, const std::size_t pos)
+			: m_map(map), m_pos(pos)
+		{
+		}
+
+		T* operator*() const { return m_map->m_values[m_pos]; }
+		std::size_t key() const { return m_map->m_keys[m_pos]; }
+		std::size_t tag() const { return m_map->m_tags[m_pos]; }
+
+		Iterator& operator++()
+		{
+			++m_pos;
+			return *this;
+		}
+
+		bool operator==(const Iterator& other) const { return m_pos == other.m_pos; }
+		bool operator!=(const Iterator& other) const { return m_pos != other.m_pos; }
+
+	private:
+		const FlatMap* m_map;
+		std::size_t    m_pos;
+	};
+
+	Iterator begin() const { return Iterator(this, 0u); }
+	Iterator end() const { return Iterator(this, m_values.size()); }
+
+	// Calls fn(T*) for every value in key order without allocating
+	template <typename Fn>
+	void forEach(Fn&& fn) const
+	{
+		for (const auto value : m_values)
+			fn(value);
+	}
+
+	FlatMap() = default;
+
+	~FlatMap()
+	{
+		clear();
+	}
+
+	FlatMap(FlatMap&&) = delete;
+	FlatMap(const FlatMap&) = delete;
+	FlatMap& operator=(FlatMap&&) = delete;
+	FlatMap& operator=(const FlatMap&) = delete;
+
+	// Delete all objects
+	void clear()
+	{
+		for (auto value : m_values)
+			delete value;
+		m_keys.clear();
+		m_values.clear();
+		m_tags.clear();
+		m_nextKey = 0;
+	}
+
+	// Inserts value at key, if key is already present the new value is deleted and the stored one is returned
+	// tag is an optional caller defined type tag kept next to the value
+	T* insert(const std::size_t key, T* value, const std::size_t tag = 0u)
+	{
+		const auto it  = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+		const auto pos = static_cast<std::size_t>(it - m_keys.begin());
+
+		if (it != m_keys.end() && *it == key) {
+			delete value;
+			return m_values[pos];
+		}
+
+		m_keys.insert(it, key);
+		m_values.insert(m_values.begin() + static_cast<std::ptrdiff_t>(pos), value);
+		m_tags.insert(m_tags.begin() + static_cast<std::ptrdiff_t>(pos), tag);
+		return value;
+	}
+
+	// Inserts value at the next free position, treating the map like an array
+	T* insert(T* value, const std::size_t tag = 0u)
+	{
+		while (find(m_nextKey) != m_keys.size())
+			++m_nextKey;
+		return insert(m_nextKey++, value, tag);
+	}
+
+	void remove(const std::size_t key)
+	{
+		const auto pos = find(key);
+		if (pos == m_keys.size())
+			return;
+
+		delete m_values[pos];
+		m_keys.erase(m_keys.begin() + static_cast<std::ptrdiff_t>(pos));
+		m_values.erase(m_values.begin() + static_cast<std::ptrdiff_t>(pos));
+		m_tags.erase(m_tags.begin() + static_cast<std::ptrdiff_t>(pos));
+	}
+
+	T* search(const std::size_t key) const
+	{
+		const auto pos = find(key);
+		return pos == m_keys.size() ? nullptr : m_values[pos];
+	}
+
+	// Gets the tag stored with key, 0 if key isn't stored
+	std::size_t tag(const std::size_t key) const
+	{
+		const auto pos = find(key);
+		return pos == m_keys.size() ? 0u : m_tags[pos];
+	}
+
+	std::vector<T*> getOrderedList() const
+	{
+		return m_values;
+	}
+
+	// Makes room for count entries in total
+	void reserve(const std::size_t count)
+	{
+		m_keys.reserve(count);
+		m_values.reserve(count);
+		m_tags.reserve(count);
+	}
+
+	std::size_t size() const
+	{
+		return m_values.size();
+	}
+
+	void print() const
+	{
+		for (const auto key : m_keys)
+			std::cout << key << " ";
+		std::cout << "\n";
+	}
+
+private:
+	// Returns the position of key, or size() if it isn't stored
+	std::size_t find(const std::size_t key) const
+	{
+		const auto count = m_keys.size();
+
+		// Keys handed out by insert(value) usually sit at their own position
+		if (key < count && m_keys[key] == key)
+			return key;
+
+		if (count <= LINEAR_SEARCH_SIZE) {
+			for (std::size_t i = 0; i < count; ++i)
+				if (m_keys[i] == key)
+					return i;
+			return count;
+		}
+
+		const auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+		return it != m_keys.end() && *it == key ? static_cast<std::size_t>(it - m_keys.begin()) : count;
+	}
+
+	std::vector<std::size_t> m_keys{};
+	std::vector<T*>          m_values{};
+	std::vector<std::size_t> m_tags{};
+	std::size_t              m_nextKey{0};
+};
@@ -7,7 +7,15 @@ float Game::TileSize = 64.f;
 
 float Game::DeltaTime = 0.0f;
 
+float    Game::TickRate = 60.0f;
+float    Game::FixedDeltaTime = 1.0f / Game::TickRate;
+unsigned Game::MaxTicksPerFrame = 5u;
+float    Game::Alpha = 0.0f;
+double   Game::Time = 0.0;
+
 Entity* Game::Global = new Entity();
+EntityRegistry Game::Registry{};
+JobSystem* Game::Jobs = nullptr;
 
 bool Game::Exit = false;
 
@@ -24,5 +32,5 @@ void Game::init(Entity* game)
 {
 
 
-	Game::Global->addIDComponent<ControllerComponent::Keyboard>("keyboard");
+	Game::Global->addIDComponent<ControllerComponent::Keyboard>("keyboard"_sid);
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 #include "Entity.h"
-
-#include <glad/glad.h>
+#include "EntityRegistry.h"
+#include "JobSystem.h"
 
 #include <glm/vec2.hpp>
 constexpr auto MAX_KEYS = 1024u;
@@ -17,8 +17,17 @@ public:
 
 	static float TileSize;
 
-	static float DeltaTime;
+	static float DeltaTime;			// seconds since the last rendered frame
+
+	// Fixed timestep simulation, update systems run TickRate times per second no matter the frame rate
+	static float    TickRate;
+	static float    FixedDeltaTime;	// seconds per tick, 1 / TickRate
+	static unsigned MaxTicksPerFrame;	// ticks run at most per frame before the simulation gives up catching up
+	static float    Alpha;				// how far rendering is between the previous and the current tick [0, 1)
+	static double   Time;				// simulation clock in seconds, advanced by FixedDeltaTime every tick
 	static Entity* Global;
+	static EntityRegistry Registry;
+	static JobSystem* Jobs;			// created in main, nullptr before
 	static bool Exit;
 	static glm::vec2 Removed;
 
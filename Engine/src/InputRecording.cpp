@@ -0,0 +1,142 @@
+#include "InputRecording.h"
+
+#include "Logger.h"
+
+#include <cstddef>
+
+namespace
+{
+	struct Header
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint32_t keys;
+		std::uint32_t reserved;
+		std::uint64_t ticks;
+		double        startTime;
+	};
+
+	template <typename T>
+	void write(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool read(std::ifstream& file, T& value)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+}
+
+namespace InputRecording
+{
+	Recorder::~Recorder()
+	{
+		close();
+	}
+
+	bool Recorder::open(const std::string& filePath)
+	{
+		close();
+
+		m_file.open(filePath, std::ios::binary | std::ios::trunc);
+		if (!m_file) {
+			Logger::error("Failed to create input recording: " + filePath, Logger::SEVERITY::MEDIUM);
+			return false;
+		}
+
+		m_keys.fill(false);
+		m_ticks = 0;
+
+		// The tick count is filled in by close()
+		write(m_file, Header{ MAGIC, VERSION, MAX_KEYS, 0u, 0u, Game::Time });
+
+		Logger::message("Recording input to " + filePath);
+		return true;
+	}
+
+	void Recorder::record()
+	{
+		if (!m_file.is_open())
+			return;
+
+		// Only keys that changed since the last tick are stored
+		m_changes.clear();
+		for (std::uint16_t key = 0; key < MAX_KEYS; ++key) {
+			if (Game::keys[key] != m_keys[key]) {
+				m_keys[key] = Game::keys[key];
+				m_changes.push_back(key);
+			}
+		}
+
+		write(m_file, Game::FixedDeltaTime);
+		write(m_file, static_cast<std::uint16_t>(m_changes.size()));
+		m_file.write(reinterpret_cast<const char*>(m_changes.data()), static_cast<std::streamsize>(m_changes.size() * sizeof(std::uint16_t)));
+		++m_ticks;
+	}
+
+	void Recorder::close()
+	{
+		if (!m_file.is_open())
+			return;
+
+		m_file.seekp(offsetof(Header, ticks));
+		write(m_file, m_ticks);
+		m_file.close();
+
+		Logger::message("Recorded " + std::to_string(m_ticks) + " ticks of input");
+	}
+
+	bool Player::open(const std::string& filePath)
+	{
+		m_file.open(filePath, std::ios::binary);
+
+		Header header{};
+		if (!m_file || !read(m_file, header) || header.magic != MAGIC || header.version != VERSION || header.keys != MAX_KEYS) {
+			Logger::error("Not a valid input recording: " + filePath, Logger::SEVERITY::MEDIUM);
+			m_file.close();
+			return false;
+		}
+
+		m_keys.fill(false);
+		m_ticks = header.ticks;
+		m_played = 0;
+
+		// Start the clock where the recording did, so clock driven systems (animations) replay the same frames
+		Game::Time = header.startTime;
+
+		Logger::message("Replaying " + std::to_string(m_ticks) + " ticks of input from " + filePath);
+		return true;
+	}
+
+	bool Player::next()
+	{
+		if (!m_file.is_open() || m_played == m_ticks)
+			return false;
+
+		float         deltaTime;
+		std::uint16_t changes;
+		if (!read(m_file, deltaTime) || !read(m_file, changes)) {
+			Logger::error("Input recording ended early after " + std::to_string(m_played) + " ticks", Logger::SEVERITY::MEDIUM);
+			m_file.close();
+			return false;
+		}
+
+		for (std::uint16_t i = 0; i < changes; ++i) {
+			std::uint16_t key;
+			if (!read(m_file, key) || key >= MAX_KEYS) {
+				Logger::error("Corrupt input recording at tick " + std::to_string(m_played), Logger::SEVERITY::MEDIUM);
+				m_file.close();
+				return false;
+			}
+			m_keys[key] = !m_keys[key];
+		}
+
+		// Whatever the window reported is overwritten, the recording is the only input while replaying
+		Game::keys = m_keys;
+		Game::FixedDeltaTime = deltaTime;
+		++m_played;
+		return true;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Game.h"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+Binary recording of the simulation's per tick inputs, so a run can be replayed tick for tick in windowed or headless mode.
+The file starts with a header (magic, version, key count, tick count and the simulation clock at the first tick), followed by one record
+per tick: the tick's FixedDeltaTime as a float, then the number of keys that changed state since the previous tick and their key codes
+as 16 bit values. Idle ticks cost 6 bytes. Values are stored in the machine's native byte order.
+*/
+namespace InputRecording
+{
+	constexpr std::uint32_t MAGIC   = 0x49475052u;	// "RPGI"
+	constexpr std::uint32_t VERSION = 1u;
+
+	/* Writes the input of every tick to a recording */
+	class Recorder
+	{
+	public:
+		Recorder() = default;
+		~Recorder();
+
+		Recorder(const Recorder&) = delete;
+		Recorder& operator=(const Recorder&) = delete;
+
+		// Starts a new recording at filePath, false if the file can't be created
+		bool open(const std::string& filePath);
+
+		// Records Game::keys and Game::FixedDeltaTime for the tick about to run
+		void record();
+
+		// Writes the tick count into the header and closes the file, also done by the destructor
+		void close();
+
+		bool isOpen() const { return m_file.is_open(); }
+
+	private:
+		std::ofstream                 m_file{};
+		std::array<bool, MAX_KEYS>    m_keys{};
+		std::vector<std::uint16_t>    m_changes{};
+		std::uint64_t                 m_ticks{0};
+	};
+
+	/* Feeds the input of a recording back into the simulation, tick by tick */
+	class Player
+	{
+	public:
+		// Opens the recording at filePath and rewinds Game::Time to where it started, false if it isn't a valid recording
+		bool open(const std::string& filePath);
+
+		// Sets Game::keys and Game::FixedDeltaTime to the next recorded tick, false once the recording is over
+		bool next();
+
+		bool isOpen() const { return m_file.is_open(); }
+
+		// Ticks in the recording
+		std::uint64_t ticks() const { return m_ticks; }
+
+	private:
+		std::ifstream              m_file{};
+		std::array<bool, MAX_KEYS> m_keys{};
+		std::uint64_t              m_ticks{0};
+		std::uint64_t              m_played{0};
+	};
+}
@@ -0,0 +1,128 @@
+#include "JobSystem.h"
+
+namespace
+{
+	// Pool and deque of the worker running on this thread, threads outside any pool use deque 0 of whichever pool they wait on
+	thread_local const JobSystem* tlsSystem = nullptr;
+	thread_local std::size_t      tlsQueue  = 0u;
+}
+
+JobSystem::JobSystem(const unsigned threads)
+{
+	const auto workers = threads > 1u ? threads - 1u : 0u;
+
+	// Deque 0 is shared by the threads waiting from outside, every worker gets one of its own
+	for (auto i = 0u; i <= workers; ++i)
+		m_queues.push_back(std::make_unique<Queue>());
+
+	for (auto i = 1u; i <= workers; ++i)
+		m_workers.emplace_back([this, i] { work(i); });
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_stop = true;
+	}
+	m_sleep.notify_all();
+
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+void JobSystem::submit(Job job, JobCounter& counter)
+{
+	counter.m_pending.fetch_add(1u, std::memory_order_relaxed);
+
+	// Workers keep their own jobs, everyone else spreads them out
+	const auto queue = tlsSystem == this ? tlsQueue : m_next.fetch_add(1u, std::memory_order_relaxed) % m_queues.size();
+	{
+		std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+		m_queues[queue]->jobs.emplace_back(std::move(job), &counter);
+	}
+	m_queued.fetch_add(1u, std::memory_order_release);
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_sleep.notify_one();
+	m_done.notify_all();
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	const auto queue = tlsSystem == this ? tlsQueue : 0u;
+
+	while (!counter.done()) {
+		if (runOne(queue))
+			continue;
+
+		// The rest of counter's jobs are running elsewhere, sleep until they finish or there is something to help with
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_done.wait(lock, [this, &counter] { return counter.done() || m_queued.load(std::memory_order_acquire) > 0; });
+	}
+}
+
+std::size_t JobSystem::threads() const
+{
+	return m_workers.size() + 1;
+}
+
+bool JobSystem::runOne(const std::size_t queue)
+{
+	std::pair<Job, JobCounter*> job;
+	auto found = false;
+
+	// Newest job of our own deque first
+	{
+		auto& own = *m_queues[queue];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			job = std::move(own.jobs.back());
+			own.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	// Otherwise steal the oldest job of another deque
+	for (std::size_t i = 1; !found && i < m_queues.size(); ++i) {
+		auto& victim = *m_queues[(queue + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			job = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+		return false;
+
+	m_queued.fetch_sub(1u, std::memory_order_relaxed);
+	job.first();
+	if (job.second->m_pending.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+		// The waiter may return and destroy the counter as soon as it sees it done, so it isn't touched past this point
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_done.notify_all();
+	}
+	return true;
+}
+
+void JobSystem::work(const std::size_t queue)
+{
+	tlsSystem = this;
+	tlsQueue = queue;
+
+	for (;;) {
+		if (runOne(queue))
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleep.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_acquire) > 0; });
+		if (m_stop && m_queued.load(std::memory_order_acquire) == 0)
+			return;
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Counts the unfinished jobs submitted against it, wait on it with JobSystem::wait */
+class JobCounter
+{
+public:
+	JobCounter() = default;
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<std::size_t> m_pending{0};
+};
+
+/*
+Work-stealing job system shared by the whole engine.
+Every worker owns a deque: it pushes and pops its own jobs at the back (newest first, still hot in cache) and steals from the front of
+the other deques (oldest first, usually the biggest pieces of work) when it runs dry. Jobs submitted from outside the pool are spread
+over the deques round robin. Waiting on a counter never blocks while there is work left: the waiting thread runs jobs itself,
+so jobs may submit and wait on other jobs (fork/join) without tying up the pool. Once nothing is left to take it sleeps until its
+counter finishes or more work is queued.
+
+	JobCounter counter;
+	Game::Jobs->submit([&] { decodeImage(a); }, counter);
+	Game::Jobs->submit([&] { decodeImage(b); }, counter);
+	Game::Jobs->wait(counter);
+
+	Game::Jobs->parallel_for(0, transforms.size(), 4096, [&](std::size_t begin, std::size_t end) { ... });
+*/
+class JobSystem
+{
+public:
+	using Job = std::function<void()>;
+
+	// threads counts the threads waiting on counters, so threads - 1 workers are started; 0 or 1 runs every job on the waiting thread
+	explicit JobSystem(unsigned threads = std::thread::hardware_concurrency());
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem(JobSystem&&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	JobSystem& operator=(JobSystem&&) = delete;
+
+	// Queues job, counter stays pending until it has run
+	void submit(Job job, JobCounter& counter);
+
+	// Runs jobs until every job submitted against counter has finished
+	void wait(JobCounter& counter);
+
+	// Calls fn(begin, end) over subranges of [begin, end) no bigger than grain, in parallel, and returns once all of them are done.
+	// Ranges are split in halves, so idle workers steal big pieces first
+	template <typename Fn>
+	void parallel_for(const std::size_t begin, const std::size_t end, const std::size_t grain, Fn&& fn)
+	{
+		if (begin >= end)
+			return;
+
+		JobCounter counter;
+		split(begin, end, std::max<std::size_t>(grain, 1u), fn, counter);
+		wait(counter);
+	}
+
+	// Threads that run jobs, counting the one that waits
+	std::size_t threads() const;
+
+private:
+	struct Queue
+	{
+		std::mutex                                    mutex{};
+		std::deque<std::pair<Job, JobCounter*>>       jobs{};
+	};
+
+	template <typename Fn>
+	void split(std::size_t begin, std::size_t end, const std::size_t grain, Fn& fn, JobCounter& counter)
+	{
+		// Hand the upper halves out and keep splitting the lower one, then run what's left here
+		while (end - begin > grain) {
+			const auto middle = begin + (end - begin) / 2;
+			submit([this, middle, end, grain, &fn, &counter] { split(middle, end, grain, fn, counter); }, counter);
+			end = middle;
+		}
+		fn(begin, end);
+	}
+
+	bool runOne(std::size_t queue);
+	void work(std::size_t queue);
+
+	std::vector<std::unique_ptr<Queue>> m_queues{};
+	std::vector<std::thread>            m_workers{};
+	std::atomic<std::size_t>            m_queued{0};
+	std::atomic<std::size_t>            m_next{0};
+	std::mutex                          m_sleepMutex{};
+	std::condition_variable             m_sleep{};	// idle workers
+	std::condition_variable             m_done{};	// threads waiting on a counter, woken when a counter finishes or jobs are queued
+	bool                                m_stop{false};
+};
@@ -0,0 +1,309 @@
+#include "Profiler.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::size_t RING_SIZE        = 1u << 14;	// zones a thread can finish between two endFrame calls, a power of two
+	constexpr std::size_t MAX_TRACE_EVENTS = 1u << 20;	// zones kept for the trace, later ones only count towards the CSV
+
+	struct Event
+	{
+		const char*  name;
+		std::int64_t start;		// nanoseconds since the profiler started
+		std::int64_t duration;	// nanoseconds
+	};
+
+	struct TraceEvent
+	{
+		Event       event;
+		std::size_t thread;
+	};
+
+	/* Single producer (the owning thread), single consumer (endFrame) ring of finished zones */
+	struct Ring
+	{
+		std::array<Event, RING_SIZE> events{};
+		std::atomic<std::size_t>     head{0};	// next slot the owner writes
+		std::atomic<std::size_t>     tail{0};	// next slot endFrame reads
+		std::atomic<std::size_t>     dropped{0};
+		std::size_t                  thread{0};
+	};
+
+	struct State
+	{
+		std::atomic<bool>                  enabled{false};
+		Clock::time_point                  epoch{Clock::now()};
+
+		std::mutex                         mutex{};	// guards rings and names, only taken once per thread and by intern
+		std::vector<std::unique_ptr<Ring>> rings{};
+		std::unordered_set<std::string>    names{};
+
+		// Only touched by the thread calling endFrame
+		std::vector<TraceEvent>                      trace{};
+		std::unordered_map<const char*, std::size_t> zoneIndex{};
+		std::vector<const char*>                     zones{};
+		std::vector<std::vector<double>>             frames{};	// milliseconds per zone and frame, negative if the zone didn't run
+		std::size_t                                  dropped{0};
+	};
+
+	State& state()
+	{
+		static State s;
+		return s;
+	}
+
+	thread_local Ring* tlsRing = nullptr;
+
+	Ring& threadRing()
+	{
+		if (!tlsRing) {
+			auto& s = state();
+			std::lock_guard<std::mutex> lock(s.mutex);
+			s.rings.push_back(std::make_unique<Ring>());
+			s.rings.back()->thread = s.rings.size() - 1;
+			tlsRing = s.rings.back().get();
+		}
+		return *tlsRing;
+	}
+
+	// Escapes name for a JSON string
+	std::string escape(const char* str)
+	{
+		std::string result;
+		for (; *str; ++str) {
+			if (*str == '"' || *str == '\\')
+				result += '\\';
+			if (static_cast<unsigned char>(*str) >= 0x20)
+				result += *str;
+		}
+		return result;
+	}
+
+	// Escapes name for a quoted CSV field
+	std::string escapeCsv(const char* str)
+	{
+		std::string result;
+		for (; *str; ++str) {
+			if (*str == '"')
+				result += '"';
+			result += *str;
+		}
+		return result;
+	}
+
+	double percentile(std::vector<double> values, const double p)
+	{
+		const auto index = static_cast<std::size_t>(std::ceil(p * static_cast<double>(values.size()))) - 1;
+		std::nth_element(values.begin(), values.begin() + index, values.end());
+		return values[index];
+	}
+}
+
+Profiler::Zone::Zone(const char* name)
+	: m_name(state().enabled.load(std::memory_order_relaxed) ? name : nullptr)
+{
+	if (m_name)
+		m_start = Clock::now();
+}
+
+Profiler::Zone::~Zone()
+{
+	if (!m_name)
+		return;
+
+	const auto end = Clock::now();
+	auto&      ring = threadRing();
+
+	// Drop the zone rather than overwrite one endFrame may be reading
+	const auto head = ring.head.load(std::memory_order_relaxed);
+	if (head - ring.tail.load(std::memory_order_acquire) == RING_SIZE) {
+		ring.dropped.fetch_add(1u, std::memory_order_relaxed);
+		return;
+	}
+
+	ring.events[head & (RING_SIZE - 1)] = Event{
+		m_name,
+		std::chrono::duration_cast<std::chrono::nanoseconds>(m_start - state().epoch).count(),
+		std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count()
+	};
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::enable(const bool enabled)
+{
+	// The thread turning profiling on gets the first ring, so it shows up as the main thread in traces
+	if (enabled)
+		threadRing();
+	state().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled()
+{
+	return state().enabled.load(std::memory_order_relaxed);
+}
+
+const char* Profiler::intern(const std::string& name)
+{
+	auto& s = state();
+	std::lock_guard<std::mutex> lock(s.mutex);
+	return s.names.insert(name).first->c_str();
+}
+
+void Profiler::endFrame()
+{
+	auto& s = state();
+	if (!s.enabled.load(std::memory_order_relaxed))
+		return;
+
+	std::vector<Ring*> rings;
+	{
+		std::lock_guard<std::mutex> lock(s.mutex);
+		for (auto& ring : s.rings)
+			rings.push_back(ring.get());
+	}
+
+	std::vector<double> frame(s.zones.size(), -1.0);
+
+	for (auto* ring : rings) {
+		const auto head = ring->head.load(std::memory_order_acquire);
+		auto       tail = ring->tail.load(std::memory_order_relaxed);
+
+		for (; tail != head; ++tail) {
+			const auto& event = ring->events[tail & (RING_SIZE - 1)];
+
+			const auto [it, added] = s.zoneIndex.emplace(event.name, s.zones.size());
+			if (added) {
+				s.zones.push_back(event.name);
+				frame.push_back(-1.0);
+			}
+
+			auto& total = frame[it->second];
+			total = std::max(total, 0.0) + static_cast<double>(event.duration) / 1e6;
+
+			if (s.trace.size() < MAX_TRACE_EVENTS)
+				s.trace.push_back(TraceEvent{ event, ring->thread });
+		}
+
+		ring->tail.store(tail, std::memory_order_release);
+		s.dropped += ring->dropped.exchange(0u, std::memory_order_relaxed);
+	}
+
+	s.frames.push_back(std::move(frame));
+}
+
+bool Profiler::writeTrace(const std::string& filePath)
+{
+	auto& s = state();
+
+	std::ofstream file(filePath);
+	if (!file) {
+		Logger::error("Failed to create trace file: " + filePath, Logger::SEVERITY::MEDIUM);
+		return false;
+	}
+
+	// Complete ("X") events with microsecond timestamps, one track per thread
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	std::size_t threads;
+	{
+		std::lock_guard<std::mutex> lock(s.mutex);
+		threads = s.rings.size();
+	}
+
+	auto first = true;
+	for (std::size_t i = 0; i < threads; ++i) {
+		file << (first ? "\n" : ",\n") << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << i
+			 << R"(,"args":{"name":")" << (i ? "thread " + std::to_string(i) : std::string("main")) << "\"}}";
+		first = false;
+	}
+
+	file.precision(3);
+	file << std::fixed;
+	for (const auto& [event, thread] : s.trace) {
+		file << (first ? "\n" : ",\n") << R"({"name":")" << escape(event.name) << R"(","ph":"X","pid":0,"tid":)" << thread
+			 << ",\"ts\":" << static_cast<double>(event.start) / 1e3 << ",\"dur\":" << static_cast<double>(event.duration) / 1e3 << '}';
+		first = false;
+	}
+	file << "\n]}\n";
+
+	if (s.trace.size() == MAX_TRACE_EVENTS)
+		Logger::warning("Trace is full, only the first " + std::to_string(MAX_TRACE_EVENTS) + " zones were written to " + filePath, Logger::SEVERITY::LOW);
+	if (s.dropped)
+		Logger::warning(std::to_string(s.dropped) + " zones were dropped because a thread's ring buffer was full", Logger::SEVERITY::LOW);
+
+	Logger::message("Wrote " + std::to_string(s.trace.size()) + " trace events to " + filePath);
+	return true;
+}
+
+bool Profiler::writeCsv(const std::string& filePath)
+{
+	auto& s = state();
+
+	std::ofstream file(filePath);
+	if (!file) {
+		Logger::error("Failed to create profile file: " + filePath, Logger::SEVERITY::MEDIUM);
+		return false;
+	}
+
+	file << "frame";
+	for (const auto* zone : s.zones)
+		file << ",\"" << escapeCsv(zone) << '"';
+	file << '\n';
+
+	// Frames a zone didn't run in are left empty and don't count towards its statistics
+	std::vector<std::vector<double>> times(s.zones.size());
+
+	file.precision(6);
+	file << std::fixed;
+	for (std::size_t f = 0; f < s.frames.size(); ++f) {
+		const auto& frame = s.frames[f];
+
+		file << f;
+		for (std::size_t z = 0; z < s.zones.size(); ++z) {
+			file << ',';
+			if (z < frame.size() && frame[z] >= 0.0) {
+				file << frame[z];
+				times[z].push_back(frame[z]);
+			}
+		}
+		file << '\n';
+	}
+
+	const auto statistic = [&file, &times](const char* label, auto&& compute)
+	{
+		file << label;
+		for (const auto& values : times) {
+			file << ',';
+			if (!values.empty())
+				file << compute(values);
+		}
+		file << '\n';
+	};
+
+	statistic("min", [](const std::vector<double>& values) { return *std::min_element(values.begin(), values.end()); });
+	statistic("avg", [](const std::vector<double>& values)
+	{
+		auto sum = 0.0;
+		for (const auto value : values)
+			sum += value;
+		return sum / static_cast<double>(values.size());
+	});
+	statistic("p99", [](const std::vector<double>& values) { return percentile(values, 0.99); });
+
+	Logger::message("Wrote " + std::to_string(s.frames.size()) + " frames of zone timings to " + filePath);
+	return true;
+}
@@ -1,5 +1,4 @@
 #pragma once
-#include <glad/glad.h>
 #include <glm/vec2.hpp>
 
 
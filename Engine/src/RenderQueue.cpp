@@ -0,0 +1,98 @@
+#include "RenderQueue.h"
+
+#include "Profiler.h"
+#include "Sort.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	constexpr std::uint64_t ID_MASK = (1u << 12) - 1u;	// shader and texture ids keep their low 12 bits
+
+	// Maps a float to an unsigned integer with the same order, negative values included
+	std::uint32_t orderedBits(const float value)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+	}
+}
+
+RenderQueue::RenderQueue(Component::Renderer& renderer)
+	: m_renderer(renderer)
+{
+}
+
+void RenderQueue::push(const std::uint8_t group, const Rect& dest, const Rect& normSrc, Component::Material& material)
+{
+	m_entries.push_back(Entry{ key(group, material, dest.y + dest.h), static_cast<std::uint32_t>(m_commands.size()) });
+	m_commands.push_back(Command{ dest, normSrc, &material });
+}
+
+void RenderQueue::draw(const std::uint8_t group, const Rect& src, const Rect& dest, Component::Material& material)
+{
+	// Translate source to fractions of the image dimensions
+	const auto imgWidth  = static_cast<float>(material.texture.width);
+	const auto imgHeight = static_cast<float>(material.texture.height);
+
+	push(group, dest, Rect{ src.x / imgWidth, src.y / imgHeight, src.w / imgWidth, src.h / imgHeight }, material);
+}
+
+void RenderQueue::submit()
+{
+	PROFILE_SCOPE("RenderQueue::submit");
+
+	if (m_sorted) {
+		PROFILE_SCOPE("RenderQueue::sort");
+		radixSort(m_entries, m_scratch, [](const Entry& entry) { return entry.key; });
+	}
+
+	// Runs of commands with the same material are reserved at once, a batch at most, and written straight into the renderer
+	const auto batch = m_renderer.batchQuads();
+	for (std::size_t first = 0; first < m_entries.size();) {
+		auto&      material = *m_commands[m_entries[first].command].material;
+		const auto limit    = std::min(m_entries.size(), first + batch);
+
+		auto last = first + 1;
+		while (last < limit && m_commands[m_entries[last].command].material == &material)
+			++last;
+
+		auto out = m_renderer.reserveQuads(last - first, material);
+		for (; first < last; ++first) {
+			const auto& command = m_commands[m_entries[first].command];
+			out = m_renderer.writeQuad(out, command.dest, command.normSrc);
+		}
+	}
+
+	clear();
+}
+
+void RenderQueue::clear()
+{
+	m_commands.clear();
+	m_entries.clear();
+}
+
+void RenderQueue::setSorted(const bool sorted)
+{
+	m_sorted = sorted;
+}
+
+bool RenderQueue::isSorted() const
+{
+	return m_sorted;
+}
+
+std::size_t RenderQueue::size() const
+{
+	return m_commands.size();
+}
+
+std::uint64_t RenderQueue::key(const std::uint8_t group, const Component::Material& material, const float depth)
+{
+	return static_cast<std::uint64_t>(group) << 56
+		   | (material.shader.getID() & ID_MASK) << 44
+		   | (material.texture.getId() & ID_MASK) << 32
+		   | orderedBits(depth);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Rect.h"
+
+#include "Components/MaterialComponent.h"
+#include "Components/RendererComponent.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+Collects a frame's sprites as draw commands and hands them to the renderer sorted, so quads sharing a shader and texture end up next to
+each other and the renderer flushes as few batches as it can.
+Every command gets a 64-bit sort key, most significant first:
+	render group (8 bits)	layers drawn back to front, e.g. the tile map (1) under the player (2), as in the data files' render_group
+	shader (12 bits)		a batch can't span shaders
+	texture (12 bits)		with a single texture slot a batch can't span textures either
+	depth (32 bits)			bottom edge of the sprite on screen, so lower sprites are drawn over higher ones
+Within a group, sprites are ordered by state before depth: sprites of different textures that overlap and need depth order
+belong in groups of their own. Commands with equal keys are drawn in the order they were pushed.
+Keys are sorted with an LSD radix sort (see Sort.h), the commands themselves never move.
+
+	queue.push(2, dest, normSrc, material);
+	...
+	queue.submit();		// once per frame, between the renderer's beginDraw and endDraw
+*/
+class RenderQueue
+{
+	struct Command
+	{
+		Rect                 dest;
+		Rect                 normSrc;
+		Component::Material* material;
+	};
+
+	struct Entry
+	{
+		std::uint64_t key;
+		std::uint32_t command;	// index into m_commands
+	};
+
+public:
+	explicit RenderQueue(Component::Renderer& renderer);
+
+	// Queues a quad, src already normalized to the image dimensions
+	void push(std::uint8_t group, const Rect& dest, const Rect& normSrc, Component::Material& material);
+
+	// Queues a quad, like Renderer::draw
+	void draw(std::uint8_t group, const Rect& src, const Rect& dest, Component::Material& material);
+
+	// Sorts the queued commands (unless unsorted), writes them to the renderer and empties the queue
+	void submit();
+
+	void clear();
+
+	// Unsorted queues submit in push order
+	void setSorted(bool sorted);
+
+	bool isSorted() const;
+
+	std::size_t size() const;
+
+	static std::uint64_t key(std::uint8_t group, const Component::Material& material, float depth);
+
+private:
+	Component::Renderer& m_renderer;
+	std::vector<Command> m_commands{};
+	std::vector<Entry>   m_entries{};
+	std::vector<Entry>   m_scratch{};	// radix sort buffer, kept between frames
+	bool                 m_sorted{true};
+};
@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 /* Simple sort functions stolen from Geeks for Geeks. */
@@ -88,4 +90,47 @@ static void insertionSort(std::vector<T>& vec)
 		}
 		vec[j + 1] = key;
 	}
+}
+
+/* LSD radix sort on the 64-bit key returned by key(value), one byte per pass, least significant first.
+Stable, so values with equal keys keep their order. Bytes every key shares are skipped, so keys only using a few bits cost fewer passes.
+scratch is a buffer the size of vec swapped with it between passes, kept by the caller so sorting every frame doesn't allocate */
+template <class T, class Key>
+static void radixSort(std::vector<T>& vec, std::vector<T>& scratch, Key key)
+{
+	constexpr std::size_t PASSES = sizeof(std::uint64_t);
+	constexpr std::size_t RADIX  = 256u;
+
+	if (vec.size() < 2)
+		return;
+
+	// Count every byte of every key in one walk over the values
+	std::size_t counts[PASSES][RADIX] = {};
+	for (const auto& value : vec) {
+		auto bits = static_cast<std::uint64_t>(key(value));
+		for (std::size_t pass = 0; pass < PASSES; ++pass, bits >>= 8)
+			++counts[pass][bits & (RADIX - 1)];
+	}
+
+	scratch.resize(vec.size());
+	for (std::size_t pass = 0; pass < PASSES; ++pass) {
+		auto&      count = counts[pass];
+		const auto shift = pass * 8;
+
+		// All keys share this byte, the pass wouldn't move anything
+		if (count[(static_cast<std::uint64_t>(key(vec.front())) >> shift) & (RADIX - 1)] == vec.size())
+			continue;
+
+		// Turn the counts into where each byte's values start
+		std::size_t offset = 0;
+		for (auto& c : count) {
+			const auto n = c;
+			c = offset;
+			offset += n;
+		}
+
+		for (const auto& value : vec)
+			scratch[count[(static_cast<std::uint64_t>(key(value)) >> shift) & (RADIX - 1)]++] = value;
+		vec.swap(scratch);
+	}
 }
\ No newline at end of file
@@ -11,8 +11,11 @@ copy and pasted (mostly) verbatim from geeks for geeks. Simple one class templat
 The main idea of splay tree is to bring the recently accessed item to root of the tree, this makes the recently searched item to be accessible in O(1) time if accessed again.
 The idea is to use locality of reference (In a typical application, 80% of the access are to 20% of the items).
 Imagine a situation where we have millions or billions of keys and only few of them are accessed frequently, which is very likely in many practical applications.
-All splay tree operations run in O(log n) time on average, where n is the number of entries in the tree. Any single operation can take Theta(n) time in the worst case. */
+All splay tree operations run in O(log n) time on average, where n is the number of entries in the tree. Any single operation can take Theta(n) time in the worst case.
+Nodes are intrusive and come out of a per tree pool of growing node blocks, removed nodes go back on the pool's free list. */
 #pragma once
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -20,29 +23,75 @@ All splay tree operations run in O(log n) time on average, where n is the number
 template <typename T>
 class SplayTree
 {
-    class Node
+    struct Node
     {
-    public:
-        Node(std::size_t key, T* value)
-            : key(key), value(value), left(nullptr), right(nullptr)
-        {
-        }
-
-        ~Node()
-        {
-            delete value;
-        }
         std::size_t key;
+        std::size_t tag;
         T* value;
-        Node* left, * right;
+        Node* left, * right;    // left doubles as the next link while the node sits in the free list
+        Node* parent;           // kept in step with every child link, so iterators can step to the successor without a search
     };
 
+    static constexpr std::size_t MIN_BLOCK_NODES = 8u;
+    static constexpr std::size_t MAX_BLOCK_NODES = 4096u;
+
+    // Adds a block of count nodes to the free list
+    void grow(std::size_t count)
+    {
+        m_blocks.push_back(std::make_unique<Node[]>(count));
+        m_blockNodes = count;
+        m_capacity += count;
+
+        auto& block = m_blocks.back();
+        for (auto i = count; i-- > 0;) {
+            block[i].left = m_free;
+            m_free = &block[i];
+        }
+    }
+
+    // Takes a node from the pool, growing it by a new block when the free list is empty
+    Node* acquire(std::size_t key, T* value, std::size_t tag)
+    {
+        if (!m_free)
+            grow(m_blocks.empty() ? MIN_BLOCK_NODES : std::min(m_blockNodes * 2, MAX_BLOCK_NODES));
+
+        Node* node = m_free;
+        m_free = node->left;
+        *node = Node{ key, tag, value, nullptr, nullptr, nullptr };
+        ++m_size;
+        return node;
+    }
+
+    // Deletes the node's value and puts the node back on the free list
+    void release(Node* node)
+    {
+        delete node->value;
+        node->value = nullptr;
+        node->right = nullptr;
+        node->left = m_free;
+        m_free = node;
+        --m_size;
+    }
+
+    // Child links always go through these so the child's parent link follows
+    static void setLeft(Node* node, Node* child)
+    {
+        node->left = child;
+        if (child) child->parent = node;
+    }
+
+    static void setRight(Node* node, Node* child)
+    {
+        node->right = child;
+        if (child) child->parent = node;
+    }
+
     // A utility function to right rotate subtree Node with y
     Node* rightRotate(Node* x)
     {
         Node* y = x->left;
-        x->left = y->right;
-        y->right = x;
+        setLeft(x, y->right);
+        setRight(y, x);
         return y;
     }
 
@@ -50,75 +99,70 @@ class SplayTree
     Node* leftRotate(Node* x)
     {
         Node* y = x->right;
-        x->right = y->left;
-        y->left = x;
+        setRight(x, y->left);
+        setLeft(y, x);
         return y;
     }
 
     // This function brings the key at node if key is present in tree.
     // If key is not present, then it brings the last accessed item at Node.
     // This function modifies the tree and returns the new Node
+    // Top-down splay (Sleator & Tarjan): the tree is split into a left tree of smaller keys and a right tree of bigger keys while walking
+    // down, then reassembled around the found node. It never recurses, so degenerate (list shaped) trees can't exhaust the stack
     Node* splay(Node* node, std::size_t key)
     {
-        // Base cases: Node is NULL or
-        // key is present at Node
-        if (node == nullptr || node->key == key)
+        if (node == nullptr)
             return node;
 
-        // Key lies in left subtree
-        if (node->key > key) {
-            // Key is not in tree, we are done
-            if (node->left == nullptr) return node;
-
-            // Zig-Zig (Left Left)
-            if (node->left->key > key) {
-                // First recursively bring the
-                // key as node of left-left
-                node->left->left = splay(node->left->left, key);
-
-                // Do first rotation for node,
-                // second rotation is done after else
-                node = rightRotate(node);
+        // header.right collects the left tree, header.left the right tree
+        Node header{};
+        Node* leftMax = &header;
+        Node* rightMin = &header;
+
+        for (;;) {
+            // Key lies in left subtree
+            if (key < node->key) {
+                // Key is not in tree, we are done
+                if (node->left == nullptr) break;
+
+                // Zig-Zig (Left Left)
+                if (key < node->left->key) {
+                    node = rightRotate(node);
+                    if (node->left == nullptr) break;
+                }
+
+                // Link node into the right tree
+                setLeft(rightMin, node);
+                rightMin = node;
+                node = node->left;
             }
-            else if (node->left->key < key) // Zig-Zag (Left Right)
-            {
-                // First recursively bring
-                // the key as node of left-right
-                node->left->right = splay(node->left->right, key);
-
-                // Do first rotation for Node->left
-                if (node->left->right != nullptr)
-                    node->left = leftRotate(node->left);
+            // Key lies in right subtree
+            else if (key > node->key) {
+                // Key is not in tree, we are done
+                if (node->right == nullptr) break;
+
+                // Zag-Zag (Right Right)
+                if (key > node->right->key) {
+                    node = leftRotate(node);
+                    if (node->right == nullptr) break;
+                }
+
+                // Link node into the left tree
+                setRight(leftMax, node);
+                leftMax = node;
+                node = node->right;
             }
-
-            // Do second rotation for node
-            return (node->left == nullptr) ? node : rightRotate(node);
+            else
+                break;
         }
-        else // Key lies in right subtree
-        {
-            // Key is not in tree, we are done
-            if (node->right == nullptr) return node;
-
-            // Zig-Zag (Right Left)
-            if (node->right->key > key) {
-                // Bring the key as Node of right-left
-                node->right->left = splay(node->right->left, key);
 
-                // Do first rotation for node->right
-                if (node->right->left != nullptr)
-                    node->right = rightRotate(node->right);
-            }
-            else if (node->right->key < key)// Zag-Zag (Right Right)
-            {
-                // Bring the key as node of
-                // right-right and do first rotation
-                node->right->right = splay(node->right->right, key);
-                node = leftRotate(node);
-            }
-
-            // Do second rotation for Node
-            return (node->right == nullptr) ? node : leftRotate(node);
-        }
+        // Reassemble the left, middle and right trees
+        setRight(leftMax, node->left);
+        setLeft(rightMin, node->right);
+        setLeft(node, header.right);
+        setRight(node, header.left);
+        node->parent = nullptr;
+        return node;
     }
 
     // A utility function to print pre-order traversal of the tree.
@@ -132,18 +176,72 @@ class SplayTree
         }
     }
 
-    void in_order(Node* node, std::vector<T*>& list)
+    // Node with the smallest key under node
+    static Node* leftmost(Node* node)
     {
-        if (node != nullptr) {
-            in_order(node->left, list);
-            list.push_back(node->value);
-            in_order(node->right, list);
-        }
+        if (node)
+            while (node->left)
+                node = node->left;
+        return node;
     }
 
     Node* m_root;
-    std::vector<std::unique_ptr<Node>> m_nodes;
+    std::vector<std::unique_ptr<Node[]>> m_blocks{};
+    Node* m_free{nullptr};
+    std::size_t m_blockNodes{0};
+    std::size_t m_capacity{0};
+    std::size_t m_size{0};
+    std::size_t m_nextKey{0};   // monotonic key handed out by insert(value)
 public:
+    /* In-order (ascending key) iterator that never allocates or splays. Each step follows child and parent links to the successor:
+    O(1) amortized over a full walk whatever the tree's shape, e.g. the single left path push_back builds. Rotations keep the key order,
+    so searches done while iterating don't invalidate it; only removing the current node does */
+    class Iterator
+    {
+    public:
+        explicit Iterator(Node* node)
+            : m_node(node)
+        {
+        }
+
+        T* operator*() const { return m_node->value; }
+        std::size_t key() const { return m_node->key; }
+        std::size_t tag() const { return m_node->tag; }
+
+        Iterator& operator++()
+        {
+            // Leftmost node of the right subtree, else the first ancestor reached from its left side
+            if (m_node->right)
+                m_node = leftmost(m_node->right);
+            else {
+                Node* child = m_node;
+                m_node = m_node->parent;
+                while (m_node && child == m_node->right) {
+                    child = m_node;
+                    m_node = m_node->parent;
+                }
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return m_node == other.m_node; }
+        bool operator!=(const Iterator& other) const { return m_node != other.m_node; }
+
+    private:
+        Node* m_node;
+    };
+
+    Iterator begin() const { return Iterator(leftmost(m_root)); }
+    Iterator end() const { return Iterator(nullptr); }
+
+    // Calls fn(T*) for every value in key order without allocating
+    template <typename Fn>
+    void forEach(Fn&& fn) const
+    {
+        for (auto it = begin(); it != end(); ++it)
+            fn(*it);
+    }
+
     SplayTree()
         : m_root(nullptr)
     {
@@ -162,18 +260,39 @@ public:
     // Delete all objects and set the root back to nullptr
     void clear()
     {
-        m_nodes.clear();
+        // Flatten the tree with right rotations while deleting, so no recursion or extra memory is needed
+        Node* node = m_root;
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            }
+            else {
+                Node* next = node->right;
+                delete node->value;
+                node = next;
+            }
+        }
+
+        m_blocks.clear();
+        m_free = nullptr;
+        m_blockNodes = 0;
+        m_capacity = 0;
+        m_size = 0;
+        m_nextKey = 0;
         m_root = nullptr;
     }
 
 
     // Function to insert a new key 'k' in splay tree with given root
-    T* insert(std::size_t k, T* value)
+    // tag is an optional caller defined type tag kept in the node
+    T* insert(std::size_t k, T* value, std::size_t tag = 0u)
     {
         // Simple Case: If tree is empty
         if (m_root == nullptr) {
-            m_root = new Node(k, value);
-            m_nodes.push_back(std::unique_ptr<Node>(m_root));
+            m_root = acquire(k, value, tag);
             return value;
         }
 
@@ -185,31 +304,33 @@ public:
             delete value;
             return m_root->value;
         }
-        // Otherwise allocate memory for new Node
-        Node* new_node = new Node(k, value);
+        // Otherwise take a new Node from the pool
+        Node* new_node = acquire(k, value, tag);
 
         // If root's key is greater, make root as right child of new node and copy the left child of root to new Node
         if (m_root->key > k) {
-            new_node->right = m_root;
-            new_node->left = m_root->left;
+            setLeft(new_node, m_root->left);
+            setRight(new_node, m_root);
             m_root->left = nullptr;
         }
 
         // If root's key is smaller, make root as left child of new Node and copy the right child of root to new Node
         else {
-            new_node->left = m_root;
-            new_node->right = m_root->right;
+            setRight(new_node, m_root->right);
+            setLeft(new_node, m_root);
             m_root->right = nullptr;
         }
 
         m_root = new_node;
-        m_nodes.push_back(std::unique_ptr<Node>(new_node));
         return value; // new node becomes new root
     }
 
-    T* insert(T* value)
+    // Inserts value at the next free key, treating the tree like an array. Keys come from a counter so they stay unique after removals
+    T* insert(T* value, std::size_t tag = 0u)
     {
-        return insert(m_nodes.size(), value);
+        while (search(m_nextKey))
+            ++m_nextKey;
+        return insert(m_nextKey++, value, tag);
     }
 
     void remove(std::size_t key)
@@ -230,6 +351,8 @@ public:
         if (!m_root->left) {
             temp = m_root;
             m_root = m_root->right;
+            if (m_root)
+                m_root->parent = nullptr;
         }
 
         // Else if left child exits
@@ -244,14 +367,10 @@ public:
             m_root = splay(m_root->left, key);
 
             // Make right child of previous root as new root's right child
-            m_root->right = temp->right;
+            setRight(m_root, temp->right);
         }
 
-        for (auto i = 0; i < m_nodes.size(); ++i)
-            if (m_nodes[i]->key == key) {
-                m_nodes.erase(m_nodes.begin() + i);
-                break;
-            }
+        release(temp);
 
         // return root of the new Splay Tree
         return;
@@ -268,16 +387,42 @@ public:
         return nullptr;
     }
 
+    // Gets the tag stored with key, 0 if key isn't in the tree
+    std::size_t tag(std::size_t key)
+    {
+        return search(key) ? m_root->tag : 0u;
+    }
+
     std::vector<T*> getOrderedList()
     {
         std::vector<T*> temp_list;
-        in_order(m_root, temp_list);
+        temp_list.reserve(m_size);
+        forEach([&temp_list](T* value) { temp_list.push_back(value); });
         return temp_list;
     }
 
+    // Makes room for count nodes in total with a single block allocation
+    void reserve(std::size_t count)
+    {
+        if (count > m_capacity)
+            grow(count - m_capacity);
+    }
+
     std::size_t size()
     {
-        return m_nodes.size();
+        return m_size;
+    }
+
+    // Nodes owned by the pool, in use or waiting on the free list
+    std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    // Bytes held by the pool: every node block plus the table of blocks, values not included
+    std::size_t memoryUsage() const
+    {
+        return m_capacity * sizeof(Node) + m_blocks.capacity() * sizeof(typename decltype(m_blocks)::value_type);
     }
 
     void print()
@@ -0,0 +1,63 @@
+#include "StringID.h"
+#include "Logger.h"
+
+#ifdef STRING_ID_CHECK_COLLISIONS
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+	std::unordered_map<std::uint64_t, std::string>& registeredNames()
+	{
+		static std::unordered_map<std::uint64_t, std::string> names;
+		return names;
+	}
+
+	// Ids are built and added from job system workers too
+	std::mutex& registeredNamesMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	// Records name under hash, logging an error if another name already is, and returns the recorded name (stable until exit)
+	const std::string& recordName(const std::uint64_t hash, const std::string_view name)
+	{
+		std::lock_guard<std::mutex> lock(registeredNamesMutex());
+		const auto [it, inserted] = registeredNames().emplace(hash, std::string(name));
+
+		if (!inserted && it->second != name)
+			Logger::error("StringID collision: \"" + it->second + "\" and \"" + std::string(name) + "\" share hash " + std::to_string(hash), Logger::SEVERITY::MEDIUM);
+		return it->second;
+	}
+}
+#endif
+
+StringID::StringID(const std::string& str)
+	: StringID(std::string_view(str))
+{
+#ifdef STRING_ID_CHECK_COLLISIONS
+	// Runtime strings are often temporaries, so the id views the recorded copy instead of str
+	m_name = recordName(m_hash, m_name);
+#endif
+}
+
+std::string StringID::toString() const
+{
+#ifdef STRING_ID_CHECK_COLLISIONS
+	// Only recorded names are owned, the id's own view may outlive the string it was built from
+	std::lock_guard<std::mutex> lock(registeredNamesMutex());
+	const auto& names = registeredNames();
+	const auto  it    = names.find(m_hash);
+	if (it != names.end())
+		return it->second;
+#endif
+	return std::to_string(m_hash);
+}
+
+void StringID::registerName() const
+{
+#ifdef STRING_ID_CHECK_COLLISIONS
+	recordName(m_hash, m_name);
+#endif
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Debug builds remember the string behind every id handed to an entity and report two strings hashing to the same id
+#ifdef _DEBUG
+#define STRING_ID_CHECK_COLLISIONS
+#endif
+
+/*
+Hashed string id (64 bit FNV-1a) used to name entity children and components.
+Hashing is constexpr, so ids built from string literals ("tiles", "keyboard"_sid) are computed at compile time; runtime strings
+go through std::string_view without building a std::string. Declaring ids used in update loops as static constexpr guarantees
+they cost nothing per lookup.
+*/
+class StringID
+{
+	static constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	static constexpr std::uint64_t FNV_PRIME        = 1099511628211ull;
+
+public:
+	template <std::size_t N>
+	constexpr StringID(const char (&str)[N])
+		: StringID(std::string_view(str, N - 1))
+	{
+	}
+
+	constexpr StringID(const std::string_view str)
+		: m_hash(hash(str))
+#ifdef STRING_ID_CHECK_COLLISIONS
+		, m_name(str)
+#endif
+	{
+	}
+
+	// Debug builds record the name right away, so ids built from temporary strings stay readable
+	StringID(const std::string& str);
+
+	constexpr std::size_t value() const { return static_cast<std::size_t>(m_hash); }
+
+	constexpr bool operator==(const StringID& other) const { return m_hash == other.m_hash; }
+	constexpr bool operator!=(const StringID& other) const { return m_hash != other.m_hash; }
+
+	static constexpr std::uint64_t hash(const std::string_view str)
+	{
+		auto result = FNV_OFFSET_BASIS;
+		for (const auto c : str) {
+			result ^= static_cast<std::uint8_t>(c);
+			result *= FNV_PRIME;
+		}
+		return result;
+	}
+
+	// Readable form for log messages, the recorded string in debug builds and the hash otherwise
+	std::string toString() const;
+
+	// Records the string behind this id and logs an error if another string was already recorded for the same hash (debug builds only).
+	// Ids built from a string_view must still have their string alive, Entity registers ids as they are added
+	void registerName() const;
+
+private:
+	std::uint64_t m_hash;
+#ifdef STRING_ID_CHECK_COLLISIONS
+	std::string_view m_name; // the recorded copy for std::string ids, else only valid while the string the id was built from is alive
+#endif
+};
+
+constexpr StringID operator""_sid(const char* str, const std::size_t length)
+{
+	return StringID(std::string_view(str, length));
+}
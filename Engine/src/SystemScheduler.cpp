@@ -0,0 +1,118 @@
+#include "SystemScheduler.h"
+
+#include <sstream>
+
+SystemScheduler::SystemScheduler(const EntityRegistry& registry, JobSystem& jobs)
+	: m_registry(registry), m_jobs(jobs)
+{
+	m_serial = m_jobs.threads() < 2;
+}
+
+SystemScheduler::Access SystemScheduler::add(const std::string& name, const Component::OwnedSystem system)
+{
+	m_entries.push_back(Entry{ name, Profiler::intern(name), system });
+	m_dirty = true;
+	return Access(*this, m_entries.size() - 1);
+}
+
+void SystemScheduler::run()
+{
+	if (m_serial) {
+		for (auto& entry : m_entries)
+			execute(entry);
+		return;
+	}
+
+	if (m_dirty)
+		build();
+
+	for (std::size_t i = 0; i < m_entries.size(); ++i)
+		m_remaining[i].store(m_entries[i].dependencies, std::memory_order_relaxed);
+
+	// Finished systems submit the dependents they release, so the counter only drops to zero once every system ran
+	JobCounter counter;
+	for (const auto root : m_roots)
+		submit(root, counter);
+	m_jobs.wait(counter);
+}
+
+void SystemScheduler::setSerial(const bool serial)
+{
+	// Without workers there is nothing to run in parallel on
+	m_serial = serial || m_jobs.threads() < 2;
+}
+
+bool SystemScheduler::isSerial() const
+{
+	return m_serial;
+}
+
+void SystemScheduler::report()
+{
+	std::ostringstream ss;
+	ss << "System timings (" << (m_serial ? "serial" : std::to_string(m_jobs.threads()) + " threads") << "):";
+
+	for (auto& entry : m_entries) {
+		const auto average = entry.runs ? std::chrono::duration<double, std::micro>(entry.time).count() / static_cast<double>(entry.runs) : 0.0;
+		ss << "\n\t" << entry.name << ": " << average << " us avg over " << entry.runs << " runs";
+
+		entry.time = std::chrono::nanoseconds{ 0 };
+		entry.runs = 0;
+	}
+
+	Logger::message(ss.str());
+}
+
+void SystemScheduler::build()
+{
+	m_roots.clear();
+	for (auto& entry : m_entries)
+		entry.dependents.clear();
+
+	// A system depends on every earlier system it conflicts with, so conflicting systems keep the order they were added in
+	for (std::size_t j = 0; j < m_entries.size(); ++j) {
+		auto& later = m_entries[j];
+		later.dependencies = 0;
+
+		for (std::size_t i = 0; i < j; ++i) {
+			const auto& earlier = m_entries[i];
+			if ((earlier.writes & (later.reads | later.writes)).any() || (earlier.reads & later.writes).any()) {
+				m_entries[i].dependents.push_back(j);
+				++later.dependencies;
+			}
+		}
+
+		if (!later.dependencies)
+			m_roots.push_back(j);
+	}
+
+	m_remaining = std::make_unique<std::atomic<std::size_t>[]>(m_entries.size());
+	m_dirty = false;
+}
+
+void SystemScheduler::execute(Entry& entry)
+{
+	// Skip systems of destroyed or inactive entities
+	if (!m_registry.shouldUpdate(entry.system.owner))
+		return;
+
+	PROFILE_SCOPE(entry.zone);
+
+	const auto start = std::chrono::steady_clock::now();
+	entry.system.system->execute();
+	entry.time += std::chrono::steady_clock::now() - start;
+	++entry.runs;
+}
+
+void SystemScheduler::submit(const std::size_t index, JobCounter& counter)
+{
+	m_jobs.submit([this, index, &counter]
+	{
+		auto& entry = m_entries[index];
+		execute(entry);
+
+		for (const auto dependent : entry.dependents)
+			if (m_remaining[dependent].fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+				submit(dependent, counter);
+	}, counter);
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include "Entity.h"
+#include "EntityRegistry.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include "Components/SystemComponent.h"
+
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+Runs systems once per frame, concurrently where it is safe to.
+Every system declares the component types it reads and writes. Two systems conflict when one of them writes a type the other one reads
+or writes, and conflicting systems run in the order they were added; that gives a dependency DAG whose independent systems
+(e.g. AnimationSystem next to CameraSystem) run at the same time as jobs on the job system, with the calling thread helping out.
+Dependencies are per component type, not per component instance, so they are conservative but never miss a conflict.
+Systems of destroyed or inactive registry entities are skipped but still release the systems waiting on them.
+Systems must not create or destroy registry entities while run() is executing them.
+Every system runs inside a profiler zone named after it.
+
+	scheduler.add("move", { playerHandle, playerMove }).reads<ControllerComponent::Keyboard>().writes<Component::Transform>();
+*/
+class SystemScheduler
+{
+	// One bit per registry component type, plus a last bit shared by every type past the registry's cap
+	using TypeMask = std::bitset<EntityRegistry::MAX_COMPONENT_TYPES + 1>;
+
+	struct Entry
+	{
+		std::string                name;
+		const char*                zone;	// name interned for the profiler
+		Component::OwnedSystem     system;
+		TypeMask                   reads{};
+		TypeMask                   writes{};
+		std::vector<std::size_t>   dependents{};
+		std::size_t                dependencies{0};
+		std::chrono::nanoseconds   time{0};
+		std::size_t                runs{0};
+	};
+
+public:
+	/* Declares what an added system touches, returned by add() */
+	class Access
+	{
+	public:
+		Access(SystemScheduler& scheduler, const std::size_t index)
+			: m_scheduler(scheduler), m_index(index)
+		{
+		}
+
+		template <typename... Ts>
+		Access& reads()
+		{
+			(m_scheduler.m_entries[m_index].reads.set(typeBit<Ts>()), ...);
+			m_scheduler.m_dirty = true;
+			return *this;
+		}
+
+		template <typename... Ts>
+		Access& writes()
+		{
+			(m_scheduler.m_entries[m_index].writes.set(typeBit<Ts>()), ...);
+			m_scheduler.m_dirty = true;
+			return *this;
+		}
+
+	private:
+		SystemScheduler& m_scheduler;
+		std::size_t      m_index;
+	};
+
+	SystemScheduler(const EntityRegistry& registry, JobSystem& jobs);
+
+	SystemScheduler(const SystemScheduler&) = delete;
+	SystemScheduler(SystemScheduler&&) = delete;
+	SystemScheduler& operator=(const SystemScheduler&) = delete;
+	SystemScheduler& operator=(SystemScheduler&&) = delete;
+
+	// Adds a system, declare what it touches on the returned Access
+	Access add(const std::string& name, Component::OwnedSystem system);
+
+	// Executes every system once, returns when all of them have finished
+	void run();
+
+	// Serial mode runs the systems one after the other on the calling thread in the order they were added, handy to rule out threading bugs
+	void setSerial(bool serial);
+	bool isSerial() const;
+
+	// Logs the average time every system took per run, and clears the timings
+	void report();
+
+private:
+	template <typename T>
+	static std::size_t typeBit()
+	{
+		// Untracked types share the overflow bit, so systems touching any of them are conservatively ordered against each other
+		const auto id = getComponentTypeID<T>();
+		return id < EntityRegistry::MAX_COMPONENT_TYPES ? id : EntityRegistry::MAX_COMPONENT_TYPES;
+	}
+
+	void build();
+	void execute(Entry& entry);
+	void submit(std::size_t index, JobCounter& counter);
+
+	const EntityRegistry&                       m_registry;
+	JobSystem&                                  m_jobs;
+	std::vector<Entry>                          m_entries{};
+	std::vector<std::size_t>                    m_roots{};
+	std::unique_ptr<std::atomic<std::size_t>[]> m_remaining{};	// dependencies left to finish this frame, per system
+	bool                                        m_dirty{false};
+	bool                                        m_serial{false};
+};
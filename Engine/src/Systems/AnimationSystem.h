@@ -2,8 +2,9 @@
 #include "Components/KeyboardComponent.h"
 #include "Components/RectComponent.h"
 #include "Components/SystemComponent.h"
+#include "Game.h"
+#include "StringID.h"
 
-#include <GLFW/glfw3.h>
 #include <glm/vec2.hpp>
 
 #include <string>
@@ -24,7 +25,8 @@ namespace System
 
 		void execute() override
 		{
-			const auto time     = static_cast<float>(glfwGetTime());
+			// Simulation clock rather than wall time, so animations advance with the ticks (and headless runs) and not the frame rate
+			const auto time     = static_cast<float>(Game::Time);
 			const auto anim_pos = static_cast<std::size_t>(time * m_speed) % m_current->size();
 			const auto anim_src = m_current->at(anim_pos);
 
@@ -34,23 +36,22 @@ namespace System
 			m_src.h = anim_src->h;
 		}
 
-		void add(const std::string& id, Anim anim)
+		void add(const StringID id, Anim anim)
 		{
-			m_animMap.emplace(id, anim);
-			m_current = &anim;
+			m_current = &m_animMap.emplace(id.value(), std::move(anim)).first->second;
 		}
 
-		// Change the textures source position
-		void play(const std::string& id)
+		// Change the textures source position, called every frame so pass ids declared static constexpr (see AnimateMoveSystem)
+		void play(const StringID id)
 		{
-			m_current = &m_animMap[id];
+			m_current = &m_animMap[id.value()];
 		}
 
 	private:
 		float								  m_speed;
 		Component::Src&                       m_src;
 		Anim*                                 m_current{nullptr};
-		std::unordered_map<std::string, Anim> m_animMap{};
+		std::unordered_map<std::size_t, Anim> m_animMap{};
 	};
 }
 
@@ -63,6 +64,16 @@ namespace System
 		System::AnimationSystem& m_animation;
 		glm::ivec2                        m_prev;
 	public:
+		// Animations played on move events, hashed once at compile time instead of on every play
+		static constexpr StringID IdleDown{ "idle down" };
+		static constexpr StringID IdleUp{ "idle up" };
+		static constexpr StringID IdleRight{ "idle right" };
+		static constexpr StringID IdleLeft{ "idle left" };
+		static constexpr StringID WalkDown{ "walk down" };
+		static constexpr StringID WalkUp{ "walk up" };
+		static constexpr StringID WalkRight{ "walk right" };
+		static constexpr StringID WalkLeft{ "walk left" };
+
 		AnimateMoveSystem(ControllerComponent::Keyboard& controller, System::AnimationSystem& animation)
 			: m_controller(controller),
 			  m_animation(animation),
@@ -77,16 +88,16 @@ namespace System
 
 			if (currDir.x || currDir.y) {
 				m_prev = currDir;
-				if (currDir.x > 0) m_animation.play("walk right");
-				else if (currDir.x < 0) m_animation.play("walk left");
-				if (currDir.y > 0) m_animation.play("walk down");
-				else if (currDir.y < 0) m_animation.play("walk up");
+				if (currDir.x > 0) m_animation.play(WalkRight);
+				else if (currDir.x < 0) m_animation.play(WalkLeft);
+				if (currDir.y > 0) m_animation.play(WalkDown);
+				else if (currDir.y < 0) m_animation.play(WalkUp);
 			}
 			else {
-				if (m_prev.x > 0) m_animation.play("idle right");
-				else if (m_prev.x < 0) m_animation.play("idle left");
-				if (m_prev.y > 0) m_animation.play("idle down");
-				else if (m_prev.y < 0) m_animation.play("idle up");
+				if (m_prev.x > 0) m_animation.play(IdleRight);
+				else if (m_prev.x < 0) m_animation.play(IdleLeft);
+				if (m_prev.y > 0) m_animation.play(IdleDown);
+				else if (m_prev.y < 0) m_animation.play(IdleUp);
 			}
 		}
 	};
@@ -3,12 +3,14 @@
 #include "Components/SystemComponent.h"
 #include "Components/TransformComponent.h"
 
+#include "Game.h"
+
 namespace System
 {
 	constexpr auto ONE_OVER_SQRT_TWO = 0.70710678118f;
-	constexpr GLfloat SPEED = 4.0f;
+	constexpr float SPEED = 240.0f;	// pixels per second
 
-	/* Updates transform position on the game world */
+	/* Updates transform position on the game world, once per simulation tick */
 	class ControllerSystem : public Component::ISystem
 	{
 		Component::Transform& m_transform;
@@ -22,20 +24,21 @@ namespace System
 
 		void execute() override
 		{
-			GLfloat x = 0.0f, y = 0.0f;
+			float x = 0.0f, y = 0.0f;
 
 			if (m_controller.keyDownRight()) x++;
 			if (m_controller.keyDownLeft()) x--;
 			if (m_controller.keyDownDown()) y++;
 			if (m_controller.keyDownUp()) y--;
 
-			if (!y && !x) {
+			// Keep diagonal movement as fast as straight movement
+			if (y && x) {
 				x *= ONE_OVER_SQRT_TWO;
 				y *= ONE_OVER_SQRT_TWO;
 			}
 
-			m_transform.x += x * SPEED;
-			m_transform.y += y * SPEED;
+			m_transform.x += x * SPEED * Game::FixedDeltaTime;
+			m_transform.y += y * SPEED * Game::FixedDeltaTime;
 		}
 	};
 }
\ No newline at end of file
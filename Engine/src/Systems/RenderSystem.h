@@ -1,22 +1,37 @@
 #pragma once
+#include "Archetype.h"
+#include "EntityRegistry.h"
+#include "Game.h"
+#include "Profiler.h"
+#include "RenderQueue.h"
+
 #include "Components/RectComponent.h"
 #include "Components/RendererComponent.h"
 #include "Components/SystemComponent.h"
 #include "Components/TransformComponent.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/ext/matrix_transform.hpp>
+
 namespace ComponentSystemRender
 {
 	/* Draw sprites on screen with respect to where the camera is located */
 	class DynamicDraw : public Component::ISystem
 	{
 	public:
-		DynamicDraw(Component::Renderer&  renderer,
+		DynamicDraw(RenderQueue&          queue,
+					const std::uint8_t    group,
 					Component::Rectangle& src,
 					Component::Rectangle& dest,
 					Component::Material&  material,
 					Component::Transform& transform,
 					Component::Transform& cameraTransform)
-			: m_renderer(renderer),
+			: m_queue(queue),
+			  m_group(group),
 				m_dest(dest),
 				m_src(src),
 			  m_material(material),
@@ -28,27 +43,241 @@ namespace ComponentSystemRender
 
 		void execute() override
 		{
+			PROFILE_SCOPE("DynamicDraw");
+
 			Component::Dest destination;
 			destination.x = m_dest.x;
 			destination.y = m_dest.y;
 			destination.w = m_dest.w;
 			destination.h = m_dest.h;
 
-			// Update render dest by camera and local transforms
-			destination.x = m_transform.x - m_camTransform.x;
-			destination.y = m_transform.y - m_camTransform.y;
+			// Update render dest by camera and local transforms, both blended between the last two simulation ticks
+			const auto position = m_transform.lerp(Game::Alpha);
+			const auto camera   = m_camTransform.lerp(Game::Alpha);
+			destination.x = position.x - camera.x;
+			destination.y = position.y - camera.y;
 			destination.w = m_transform.w * m_transform.scale;
 			destination.h = m_transform.h * m_transform.scale;
 
-			m_renderer.draw(m_src, destination, m_material);
+			m_queue.draw(m_group, m_src, destination, m_material);
 		}
 
 	private:
-		Component::Renderer&  m_renderer;
+		RenderQueue&          m_queue;
+		std::uint8_t          m_group;	// render group, see RenderQueue
 		Component::Dest&      m_dest;
 		Component::Src&       m_src;
 		Component::Material&  m_material;
 		Component::Transform& m_transform;		// local transform
 		Component::Transform& m_camTransform;
 	};
-}
+
+	using SpriteArchetype = Archetype<Component::Transform, Component::Src>;
+
+	/* Draw a tile layer with respect to where the camera is located. Tiles never move, so they are cached on the GPU in chunks of
+	CHUNK_SIZE x CHUNK_SIZE tiles, each uploaded once in world space and drawn with the camera as the view matrix: a steady frame
+	uploads nothing for the tile map. A chunk is only rebuilt after invalidate() marks one of its tiles as changed.
+	Tiles are expected row major (tile i at column i % cols, row i / cols, tileSize apart from the origin), which lets the chunks under
+	the camera be found by index arithmetic, so the cost follows the screen, not the map.
+	Chunks are drawn as soon as the system runs, under whatever the render queue submits afterwards.
+	The chunks' buffers are deleted with the system, so it has to be destroyed while the GL context is still current.
+	TRenderer, TMaterial and TQuads stand in for Component::Renderer, Material and StaticQuads, so the Tests project can run the system
+	against a renderer counting what it is given instead of drawing it (see TileMapDraw for the one the game uses) */
+	template <typename TRenderer, typename TMaterial = Component::Material, typename TQuads = Component::StaticQuads>
+	class BasicTileMapDraw : public Component::ISystem
+	{
+	public:
+		static constexpr std::size_t CHUNK_SIZE = 16u;	// tiles along each side of a chunk
+
+		BasicTileMapDraw(TRenderer&            renderer,
+						 SpriteArchetype&      tiles,
+						 TMaterial&            material,
+						 Component::Transform& cameraTransform,
+						 const std::size_t     cols,
+						 const float           tileSize)
+			: m_renderer(renderer),
+			  m_tiles(tiles),
+			  m_material(material),
+			  m_camTransform(cameraTransform),
+			  m_cols(cols),
+			  m_tileSize(tileSize)
+		{
+		}
+
+		void execute() override
+		{
+			PROFILE_SCOPE("TileMapDraw");
+
+			const auto rows   = m_cols ? (m_tiles.size() + m_cols - 1) / m_cols : 0u;
+			const auto camera = m_camTransform.lerp(Game::Alpha);
+
+			// Tiles were added or removed, every chunk has to be laid out again
+			if (m_tileCount != m_tiles.size())
+				reset(rows);
+
+			// Visible tile range: every tile the view overlaps, even partly when the view doesn't line up with the grid, and no more
+			const auto firstCol = visibleStart(camera.x, m_tileSize, m_cols);
+			const auto lastCol  = visibleEnd(camera.x + Game::Width, m_tileSize, m_cols);
+			const auto firstRow = visibleStart(camera.y, m_tileSize, rows);
+			const auto lastRow  = visibleEnd(camera.y + Game::Height, m_tileSize, rows);
+
+			if (firstCol >= lastCol || firstRow >= lastRow)
+				return;
+
+			const auto view = glm::translate(glm::mat4(1.0f), glm::vec3(-camera.x, -camera.y, 0.0f));
+
+			for (auto chunkRow = firstRow / CHUNK_SIZE; chunkRow <= (lastRow - 1) / CHUNK_SIZE; ++chunkRow) {
+				for (auto chunkCol = firstCol / CHUNK_SIZE; chunkCol <= (lastCol - 1) / CHUNK_SIZE; ++chunkCol) {
+					auto& chunk = m_chunks[chunkRow * m_chunkCols + chunkCol];
+					if (chunk.dirty)
+						build(chunk, chunkRow, chunkCol);
+
+					m_renderer.drawStatic(chunk.quads, m_material, view);
+				}
+			}
+		}
+
+		// Rebuilds the chunk holding tile before it is drawn next
+		void invalidate(const std::size_t tile)
+		{
+			if (!m_cols)
+				return;
+
+			const auto chunk = tile / m_cols / CHUNK_SIZE * m_chunkCols + tile % m_cols / CHUNK_SIZE;
+			if (chunk < m_chunks.size())
+				m_chunks[chunk].dirty = true;
+		}
+
+		// Rebuilds every chunk before it is drawn next
+		void invalidate()
+		{
+			for (auto& chunk : m_chunks)
+				chunk.dirty = true;
+		}
+
+		// First tile index at or before position, clamped to [0, count]
+		static std::size_t visibleStart(const float position, const float tileSize, const std::size_t count)
+		{
+			const auto tile = std::floor(position / tileSize);
+			return tile <= 0.f ? 0u : std::min(static_cast<std::size_t>(tile), count);
+		}
+
+		// One past the last tile starting before position, clamped to [0, count]
+		static std::size_t visibleEnd(const float position, const float tileSize, const std::size_t count)
+		{
+			const auto tile = std::ceil(position / tileSize);
+			return tile <= 0.f ? 0u : std::min(static_cast<std::size_t>(tile), count);
+		}
+
+	private:
+		struct Chunk
+		{
+			TQuads quads{};
+			bool   dirty{true};
+		};
+
+		void reset(const std::size_t rows)
+		{
+			m_chunkCols = (m_cols + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			m_chunks.clear();
+			m_chunks.resize(m_chunkCols * ((rows + CHUNK_SIZE - 1) / CHUNK_SIZE));
+			m_tileCount = m_tiles.size();
+		}
+
+		void build(Chunk& chunk, const std::size_t chunkRow, const std::size_t chunkCol)
+		{
+			// Normalize srcs by multiplying with the reciprocal image dimensions instead of dividing per tile
+			const auto invWidth  = 1.0f / static_cast<float>(m_material.texture.width);
+			const auto invHeight = 1.0f / static_cast<float>(m_material.texture.height);
+
+			const auto firstCol = chunkCol * CHUNK_SIZE;
+			const auto lastCol  = std::min(firstCol + CHUNK_SIZE, m_cols);
+			const auto firstRow = chunkRow * CHUNK_SIZE;
+
+			m_vertices.resize(CHUNK_SIZE * CHUNK_SIZE * m_renderer.quadFloats());
+			auto out = m_vertices.data();
+
+			const auto emit = [&](const std::size_t count, Component::Transform* transforms, Component::Src* srcs)
+			{
+				for (std::size_t i = 0; i < count; ++i) {
+					const auto& transform = transforms[i];
+					const auto& src       = srcs[i];
+
+					// Chunks stay in world space, the camera is applied by the view matrix
+					const Rect destination{ transform.x, transform.y, transform.w * transform.scale, transform.h * transform.scale };
+					const Rect normSrc{ src.x * invWidth, src.y * invHeight, src.w * invWidth, src.h * invHeight };
+
+					out = m_renderer.writeStaticQuad(out, destination, normSrc);
+				}
+			};
+
+			// Each row of the chunk is one contiguous run of tiles
+			for (auto row = firstRow; row < firstRow + CHUNK_SIZE; ++row)
+				m_tiles.eachRange(std::min(row * m_cols + firstCol, m_tiles.size()), std::min(row * m_cols + lastCol, m_tiles.size()), emit);
+
+			m_vertices.resize(static_cast<std::size_t>(out - m_vertices.data()));
+			m_renderer.upload(chunk.quads, m_vertices);
+			chunk.dirty = false;
+		}
+
+		TRenderer&            m_renderer;
+		SpriteArchetype&      m_tiles;
+		TMaterial&            m_material;
+		Component::Transform& m_camTransform;
+		std::size_t           m_cols;
+		float                 m_tileSize;
+
+		// Chunk cache
+		std::vector<Chunk>    m_chunks{};		// row major, m_chunkCols per row
+		std::size_t           m_chunkCols{0};
+		std::size_t           m_tileCount{0};	// tiles the chunks were laid out for
+		std::vector<float>    m_vertices{};		// chunk being built
+	};
+
+	using TileMapDraw = BasicTileMapDraw<Component::Renderer>;
+
+	/* Draw every registry entity with a transform, src and material with respect to where the camera is located.
+	One system for all of them instead of a DynamicDraw per sprite, new sprites are picked up through the registry view */
+	class SpriteDraw : public Component::ISystem
+	{
+	public:
+		SpriteDraw(RenderQueue&          queue,
+				   const std::uint8_t    group,
+				   EntityRegistry&       registry,
+				   Component::Transform& cameraTransform)
+			: m_queue(queue),
+			  m_group(group),
+			  m_registry(registry),
+			  m_camTransform(cameraTransform)
+		{
+		}
+
+		void execute() override
+		{
+			PROFILE_SCOPE("SpriteDraw");
+
+			const auto camera = m_camTransform.lerp(Game::Alpha);
+
+			m_registry.view<Component::Transform, Component::Src, Component::Material>().each(
+				[this, &camera](Component::Transform& transform, Component::Src& src, Component::Material& material)
+			{
+				// Update render dest by camera and local transforms, both blended between the last two simulation ticks
+				const auto position = transform.lerp(Game::Alpha);
+				const Rect destination{
+					position.x - camera.x,
+					position.y - camera.y,
+					transform.w * transform.scale,
+					transform.h * transform.scale
+				};
+
+				m_queue.draw(m_group, src, destination, material);
+			});
+		}
+
+	private:
+		RenderQueue&          m_queue;
+		std::uint8_t          m_group;
+		EntityRegistry&       m_registry;
+		Component::Transform& m_camTransform;
+	};
+}
\ No newline at end of file
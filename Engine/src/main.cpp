@@ -1,31 +1,49 @@
 // ReSharper disable CppClangTidyBugproneIntegerDivision
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <string>
 
+// Define HEADLESS_ONLY to build nothing but the headless mode, without GLFW, glad or any of the rendering code (see the Headless project)
+#ifndef HEADLESS_ONLY
 #include <GLFW/glfw3.h>
 
 #include <glad/glad.h>
 
 #include <glm/ext/matrix_clip_space.hpp>
+#endif
 
 #include "Entity.h"
 #include "Game.h"
+#include "InputRecording.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "SystemScheduler.h"
+#include "stb_image.h"
 
 #include "Components/KeyboardComponent.h"
-#include "Components/MaterialComponent.h"
 #include "Components/RectComponent.h"
-#include "Components/RendererComponent.h"
-#include "Components/ShaderComponent.h"
-#include "Components/TextureComponent.h"
 #include "Components/TransformComponent.h"
 
 #include "Systems/AnimationSystem.h"
 #include "Systems/CameraSystem.h"
 #include "Systems/MoveSystem.h"
+
+#ifndef HEADLESS_ONLY
+#include "RenderQueue.h"
+
+#include "Components/MaterialComponent.h"
+#include "Components/RendererComponent.h"
+#include "Components/ShaderComponent.h"
+#include "Components/TextureComponent.h"
+
 #include "Systems/RenderSystem.h"
+#endif
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 // GLOBAL VARIABLES
@@ -37,20 +55,64 @@ constexpr int SCREEN_HEIGHT = 768;
 
 // Global game variables
 constexpr auto   SPEED       = 4.0f;
-constexpr GLuint MAX_SPRITES = 255;
-constexpr GLint  ROWS        = 32;
-constexpr GLint  COLS        = 32;
+constexpr unsigned MAX_SPRITES = 255;
+constexpr int      ROWS        = 32;
+constexpr int      COLS        = 32;
+
+// Render group of queued sprites (the render_group of player.json). The tile map (group 1) is cached on the GPU and drawn before the queue
+constexpr std::uint8_t SPRITE_GROUP = 2;
+
+// Run update systems one after the other instead of as jobs
+constexpr bool SERIAL_SYSTEMS = false;
+
+// Ticks simulated by --headless when no count is given
+constexpr std::size_t HEADLESS_TICKS = 100000;
+
+// Texture filepath's
+constexpr auto FLESH_PATH = "Resources/Images/flesh_full.png";
+constexpr auto GRASS_PATH = "Resources/Images/grass.png";
 
 Rect SRC{0.0f, 0.0f, 64.0f, 64.0f};
 
+// Command line options
+struct Options
+{
+	bool        headless{false};
+	std::size_t ticks{HEADLESS_TICKS};
+	std::string record{};	// file to record input to
+	std::string replay{};	// file to replay input from
+	std::string profile{};	// file name the profiler trace (.json) and timings (.csv) are written to, without extension
+#ifndef HEADLESS_ONLY
+	Component::Renderer::QuadMode  quadMode{Component::Renderer::QuadMode::Indexed};
+	Component::Renderer::Streaming streaming{Component::Renderer::Streaming::Persistent};
+	unsigned int                   textureSlots{Component::Renderer::MAX_TEXTURE_SLOTS};
+	bool                           sortDraws{true};
+#endif
+};
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 // GLOBAL FUNCTION DEFINITIONS
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef HEADLESS_ONLY
 void keyCallback(GLFWwindow* window, int key, int scanCode, int action, int mode);
 
 void processInput(GLFWwindow* window, Component::Transform& transform);		// process input for the player
 void framebufferSizeCallback(GLFWwindow* window, int width, int height);
-
+#endif
+void scriptInput(std::size_t tick);													// scripted input for headless runs
+
+EntityHandle createPlayer(SystemScheduler&               updateSystems,
+						  ControllerComponent::Keyboard& controller,
+						  Component::Transform&          cameraTransform,
+						  Entity&                        animationFrames,
+						  unsigned                       texCols);
+bool tick(SystemScheduler& updateSystems, InputRecording::Recorder& recorder, InputRecording::Player& player);
+Options parseOptions(int argc, char* argv[]);
+int runHeadless(const Options& options);
+void writeProfile(const Options& options);
+int checkLeaks();
+
+#ifndef HEADLESS_ONLY
 void APIENTRY glDebugOutput(GLenum       source,
 							GLenum       type,
 							unsigned int id,
@@ -58,11 +120,26 @@ void APIENTRY glDebugOutput(GLenum       source,
 							GLsizei      length,
 							const char*  message,
 							const void*  userParam);
+#endif
 
-int main()
+int main(const int argc, char* argv[])
 {
 	// Logger::toFile(); // save logger to file
 
+	const auto options = parseOptions(argc, argv);
+	Profiler::enable(!options.profile.empty());
+
+	// Created here rather than as a static, so its workers never start during static initialization
+	JobSystem jobs;
+	Game::Jobs = &jobs;
+
+#ifdef HEADLESS_ONLY
+	// Nothing else was built
+	return runHeadless(options);
+#else
+	if (options.headless)
+		return runHeadless(options);
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// INITIALIZATION
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -74,9 +151,9 @@ int main()
 		return -1;
 	}
 
-	// OpenGL version = major.minor (4.6)
+	// OpenGL version = major.minor (4.5), nothing newer is used and it's as far as Mesa's llvmpipe goes
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
 	// Allow debug message early
 	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
 
@@ -84,6 +161,11 @@ int main()
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 	const auto window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "OpenGL RPG", nullptr, nullptr);
+	if (!window) {
+		Logger::error("Failed to create an OpenGL 4.5 window", Logger::SEVERITY::MEDIUM);
+		glfwTerminate();
+		return -1;
+	}
 	glfwMakeContextCurrent(window);
 
 	// Make the window resizable and scale the renderer
@@ -114,14 +196,18 @@ int main()
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Set up engine, will be its own thing soon enough
-	std::vector<Component::ISystem*> renderSystems;
-	std::vector<Component::ISystem*> updateSystems;
+	// Rendering stays on the main thread (it owns the GL context), updates go through the scheduler
+	std::vector<Component::OwnedSystem> renderSystems;
+	SystemScheduler                     updateSystems(Game::Registry, *Game::Jobs);
+	updateSystems.setSerial(SERIAL_SYSTEMS);
 
 	// Set up entities and their components
 
 	// Shader filepath's
-	constexpr auto vsFilepath = "Resources/Shaders/sprite.vs";
-	constexpr auto fsFilepath = "Resources/Shaders/sprite.fs";
+	// Instanced quads are expanded by their own vertex shader
+	const auto     vsFilepath = options.quadMode == Component::Renderer::QuadMode::Instanced ? "Resources/Shaders/sprite_instanced.vs" : "Resources/Shaders/sprite.vs";
+	// Batches spanning several textures sample the one of each sprite's slot
+	const auto     fsFilepath = options.textureSlots > 1u ? "Resources/Shaders/sprite_batch.fs" : "Resources/Shaders/sprite.fs";
 
 	// Shader Entity
 	const auto shaders          = new Entity();
@@ -134,194 +220,437 @@ int main()
 	shaderComponent.use();
 	const auto projection = glm::ortho(0.0f, Game::Width, Game::Height, 0.0f, -1.0f, 1.0f);
 	shaderComponent.setMat4("projection", projection);
-
-	// Texture filepath's
-	const auto fleshPath = "Resources/Images/flesh_full.png";
-	const auto grassPath = "Resources/Images/grass.png";
+	shaderComponent.setMat4("view", glm::mat4(1.0f));
 
 	auto* textures = new Entity();
 
 	auto& fleshTexture = *textures->push_back<Component::Texture>();
-	fleshTexture.load(fleshPath);
+	fleshTexture.load(FLESH_PATH);
 
 	auto& grassTexture = *textures->push_back<Component::Texture>();
-	grassTexture.load(grassPath);
+	grassTexture.load(GRASS_PATH);
 
 	// Create a renderer object and input appropriate attribute sizes (2 = pos, 2 = coords)
 	// Renderer Entity
 	const auto renderer        = new Entity();
-	auto&      renderComponent = *renderer->addComponent<Component::Renderer>(std::vector<GLuint>{2, 2}, MAX_SPRITES); // grass texture
+	auto&      renderComponent = *renderer->addComponent<Component::Renderer>(std::vector<GLuint>{2, 2}, MAX_SPRITES, options.quadMode, options.streaming, options.textureSlots); // grass texture
+
+	// Render systems queue their sprites, which are sorted by render group and state before they reach the renderer
+	RenderQueue renderQueue(renderComponent);
+	renderQueue.setSorted(options.sortDraws);
 
 	// Setup controller
 	const auto  controller          = new Entity();
 	auto& controllerComponent = *controller->addComponent<ControllerComponent::Keyboard>();
 
 	// Setup camera entity
-	const auto camera          = new Entity();
-	auto&      cameraTransform = *camera->addComponent<Component::Transform>(0.f, 0.f, ROWS * Game::TileSize); // position = (0, 0) width/height = 32 tiles * 64 length of tile
+	const auto cameraHandle    = Game::Registry.create();
+	auto&      cameraTransform = *Game::Registry.addComponent<Component::Transform>(cameraHandle, 0.f, 0.f, ROWS * Game::TileSize); // position = (0, 0) width/height = 32 tiles * 64 length of tile
 
 	// Setup tile map
-	const auto tileMap         = new Entity();
+	const auto tileMapHandle   = Game::Registry.create();
+	const auto tileMap         = Game::Registry.get(tileMapHandle);
 	auto&      tileMapMaterial = *tileMap->addComponent<Component::Material>(grassTexture, shaderComponent, 1); // grass texture
 
 	// How many total grass textures to draw?
 	constexpr auto totalTiles = COLS * ROWS;
 
-	const auto tiles = new Entity();
-	tileMap->push_back_child(tiles);
-
-	// Setup tiles for tile map
-	for (auto i = 0; i < totalTiles; ++i) {
+	// Tiles share the same component set, so they live together in one archetype instead of as separate heap objects
+	auto& tileLayer = *tileMap->addComponent<ComponentSystemRender::SpriteArchetype>();
 
+	// Setup tiles for tile map, all rows are allocated once and built in place
+	tileLayer.createMany(totalTiles, [](const std::size_t i)
+	{
 		const float x = static_cast<float>((i % COLS)) * Game::TileSize; // finds place in column and multiplies by sprite width
 		const float y = static_cast<float>((i / COLS)) * Game::TileSize; // finds place in row and multiplies by sprite height
 
-		auto& grassDest = *tiles->push_back<Component::Dest>( x, y, Game::TileSize, Game::TileSize );
-		auto& tileTransform = *tiles->push_back<Component::Transform>(grassDest);
-		auto& src           = *tiles->push_back<Component::Src>(SRC);
-		auto& dest          = *tiles->push_back<Component::Dest>();
+		return std::make_tuple(Rect{ x, y, Game::TileSize, Game::TileSize }, SRC);
+	});
+
+	const auto tileMapDraw = tileMap->addComponent<ComponentSystemRender::TileMapDraw>(renderComponent, tileLayer, tileMapMaterial, cameraTransform, COLS, Game::TileSize);
+	renderSystems.push_back({ tileMapHandle, tileMapDraw });
+
+	// Setup player and it's components, the material makes it show up in SpriteDraw
+	const auto animation    = new Entity();
+	const auto playerHandle = createPlayer(updateSystems, controllerComponent, cameraTransform, *animation, fleshTexture.width / 64u);
+	Game::Registry.addComponent<Component::Material>(playerHandle, fleshTexture, shaderComponent, 0);
+
+	// Draws the player and every other sprite entity in the registry
+	const auto spriteDraw = renderer->addComponent<ComponentSystemRender::SpriteDraw>(renderQueue, SPRITE_GROUP, Game::Registry, cameraTransform);
+	renderSystems.push_back({ EntityHandle{}, spriteDraw });
+
+	Logger::message("Entities Created: " + std::to_string(Entity::count));
+	Logger::message("Components Created: " + std::to_string(IComponent::count));
+	Logger::message("Component Pool: " + std::to_string(ComponentAllocator::live()) + " live, "
+					+ std::to_string(ComponentAllocator::capacity()) + " bytes reserved, "
+					+ std::to_string(static_cast<int>(ComponentAllocator::freeRatio() * 100.f)) + "% free");
+
+	// Input is recorded or replayed per tick, so a replay runs the same simulation no matter the frame rate
+	InputRecording::Recorder recorder;
+	InputRecording::Player   player;
+	if (!options.record.empty())
+		recorder.open(options.record);
+	if (!options.replay.empty())
+		player.open(options.replay);
+
+	auto lastFrame   = static_cast<GLfloat>(glfwGetTime());
+	auto accumulator = 0.0f;	// simulation time owed, drained in fixed ticks
+
+	std::size_t frames        = 0;
+	std::size_t drawCalls     = 0;
+	std::size_t uploadedBytes = 0;
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Game loop
+	while (!glfwWindowShouldClose(window)) {
+		// calculate delta time
+		const auto currentFrame = static_cast<GLfloat>(glfwGetTime());
+		Game::DeltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// INPUT
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//processInput(window, playerTransform);
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// UPDATE
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		// Run the simulation in fixed ticks, catching up on at most MaxTicksPerFrame of them so a slow frame can't spiral
+		Game::FixedDeltaTime = 1.0f / Game::TickRate;
+		accumulator += Game::DeltaTime;
+
+		{
+			PROFILE_SCOPE("update");
+
+			auto ticks = 0u;
+			while (accumulator >= Game::FixedDeltaTime && ticks < Game::MaxTicksPerFrame) {
+				// Close once the replay is over
+				if (!tick(updateSystems, recorder, player)) {
+					glfwSetWindowShouldClose(window, GL_TRUE);
+					break;
+				}
+
+				accumulator -= Game::FixedDeltaTime;
+				++ticks;
+			}
+		}
+
+		// Drop whatever time is still owed after giving up catching up
+		if (accumulator >= Game::FixedDeltaTime)
+			accumulator = std::fmod(accumulator, Game::FixedDeltaTime);
+
+		Game::Alpha = accumulator / Game::FixedDeltaTime;
 
-		const auto tileDynamicDrawComp = tiles->push_back<ComponentSystemRender::DynamicDraw>(renderComponent, src,dest, tileMapMaterial, tileTransform, cameraTransform);
-		renderSystems.push_back(tileDynamicDrawComp);
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// DRAW
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		{
+			PROFILE_SCOPE("draw");
+
+			// Clears screen to black
+			renderComponent.clear();
+
+			// Begin batch drawing
+			renderComponent.beginDraw();
+
+			// Queue the frame's sprites
+			for (const auto& draw : renderSystems) {
+				if (Game::Registry.shouldUpdate(draw.owner))
+					draw.system->execute();
+			}
+
+			// Make draw calls to renderer
+			renderQueue.submit();
+
+			// End batch drawing
+			renderComponent.endDraw();
+
+			renderComponent.display();
+			drawCalls += renderComponent.drawCalls();
+			uploadedBytes += renderComponent.uploadedBytes();
+			++frames;
+		}
+
+		{
+			PROFILE_SCOPE("swap");
+			glfwSwapBuffers(window);
+		}
+		glfwPollEvents();
+
+		// Clean up entities destroyed during this frame
+		Game::Registry.flush();
+
+		Profiler::endFrame();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// CLEAN-UP
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	updateSystems.report();
+	if (frames) {
+		Logger::message("Draw calls: " + std::to_string(static_cast<double>(drawCalls) / static_cast<double>(frames)) + " per frame over " +
+						std::to_string(frames) + " frames (" + std::to_string(renderComponent.textureSlots()) + " texture slots, " +
+						(renderQueue.isSorted() ? "sorted" : "unsorted") + ")");
+		Logger::message("Vertex uploads: " + std::to_string(static_cast<double>(uploadedBytes) / static_cast<double>(frames)) + " bytes per frame");
 	}
-	
+	writeProfile(options);
+	// delete entities and their components, the tile map's chunk buffers go with the registry
+	Game::Registry.clear();
+	delete shaders;
+	delete textures;
+	delete renderer;
+
+	// The registry's tile chunks and the renderer delete GL buffers (and the renderer its fences), so the context has to outlive them
+	glfwTerminate();
+
+	delete controller;
+	delete animation;
+	delete Game::Global;
+	Game::Global = nullptr;
 
-	// Setup player and it's components
-	const auto player = new Entity();
+	return checkLeaks();
+#endif
+}
+
+EntityHandle createPlayer(SystemScheduler&               updateSystems,
+						  ControllerComponent::Keyboard& controller,
+						  Component::Transform&          cameraTransform,
+						  Entity&                        animationFrames,
+						  const unsigned                 texCols)
+{
+	const auto playerHandle = Game::Registry.create();
+	const auto player       = Game::Registry.get(playerHandle);
 
-	auto&      playerTransform   = *player->addComponent<Component::Transform>(Game::Width, Game::Height, Game::TileSize);
-	auto&      playerSrc         = *player->addComponent<Component::Src>(SRC); // src is full image, dest is set up during dynamic draw
-	auto&      playerDest        = *player->addComponent<Component::Dest>();
-	auto&      playerMaterial    = *player->addComponent<Component::Material>(fleshTexture, shaderComponent, 0);
+	// Components added through the registry make the player show up in its views
+	auto&      playerTransform   = *Game::Registry.addComponent<Component::Transform>(playerHandle, Game::Width, Game::Height, Game::TileSize);
+	auto&      playerSrc         = *Game::Registry.addComponent<Component::Src>(playerHandle, SRC); // src is full image, dest is set up during draw
 
-	const auto playerDynamicDraw = player->addComponent<ComponentSystemRender::DynamicDraw>(renderComponent, playerSrc, playerDest, playerMaterial, playerTransform, cameraTransform);
 	const auto playerCamera      = player->addComponent<System::CameraSystem>(playerTransform, cameraTransform);
-	const auto playerMove        = player->addComponent<System::ControllerSystem>(playerTransform, controllerComponent);
+	const auto playerMove        = player->addComponent<System::ControllerSystem>(playerTransform, controller);
 
 	const auto playerAnimation   = player->addComponent<System::AnimationSystem>(4.f, playerSrc);
-	const auto playerAnimateMove = player->addComponent<System::AnimateMoveSystem>(controllerComponent, *playerAnimation);
+	const auto playerAnimateMove = player->addComponent<System::AnimateMoveSystem>(controller, *playerAnimation);
 
 	// set up flesh animations
-	const std::string anims[] = {
-		"idle down",
-		"idle up",
-		"idle right",
-		"idle left",
-		"walk down",
-		"walk up",
-		"walk right",
-		"walk left"
+	const StringID anims[] = {
+		System::AnimateMoveSystem::IdleDown,
+		System::AnimateMoveSystem::IdleUp,
+		System::AnimateMoveSystem::IdleRight,
+		System::AnimateMoveSystem::IdleLeft,
+		System::AnimateMoveSystem::WalkDown,
+		System::AnimateMoveSystem::WalkUp,
+		System::AnimateMoveSystem::WalkRight,
+		System::AnimateMoveSystem::WalkLeft
 	};
 
-	auto       animIdx    = 0u;
-	const auto animation = new Entity();
-
-	const auto fleshTexCols = fleshTexture.width / 64u;
+	auto animIdx = 0u;
 
 	for (auto i = 0; i < 4; ++i) {
 		Rect rect{
-			static_cast<float>(animIdx % fleshTexCols) * Game::TileSize,
-			static_cast<float>(animIdx / fleshTexCols) * Game::TileSize,
+			static_cast<float>(animIdx % texCols) * Game::TileSize,
+			static_cast<float>(animIdx / texCols) * Game::TileSize,
 			Game::TileSize,
 			Game::TileSize
 		};
 
-		const auto idle = animation->push_back<Component::Src>(rect);
+		const auto idle = animationFrames.push_back<Component::Src>(rect);
 		playerAnimation->add(anims[animIdx++], Anim{ idle });
 	}
 
 	for (auto i = 0; i < 4; ++i) {
 		Rect rect{
-			static_cast<float>((animIdx + i) % fleshTexCols) * Game::TileSize,
-			static_cast<float>((animIdx + i) / fleshTexCols) * Game::TileSize,
+			static_cast<float>((animIdx + i) % texCols) * Game::TileSize,
+			static_cast<float>((animIdx + i) / texCols) * Game::TileSize,
 			Game::TileSize,
 			Game::TileSize
 		};
 
 		Rect rect2{
-			static_cast<float>((animIdx + i + 1) % fleshTexCols) * Game::TileSize,
-			static_cast<float>((animIdx + i + 1) / fleshTexCols) * Game::TileSize,
+			static_cast<float>((animIdx + i + 1) % texCols) * Game::TileSize,
+			static_cast<float>((animIdx + i + 1) / texCols) * Game::TileSize,
 			Game::TileSize,
 			Game::TileSize
 		};
 
-		const auto walk1 = animation->push_back<Component::Src>(rect);
-		const auto walk2 = animation->push_back<Component::Src>(rect2);
+		const auto walk1 = animationFrames.push_back<Component::Src>(rect);
+		const auto walk2 = animationFrames.push_back<Component::Src>(rect2);
 		playerAnimation->add(anims[animIdx++], Anim{ walk1, walk2 });
 	}
 
-	renderSystems.push_back(playerDynamicDraw);
-	updateSystems.push_back(playerMove);
-	updateSystems.push_back(playerCamera);
-	updateSystems.push_back(playerAnimateMove);
-	updateSystems.push_back(playerAnimation);
+	// Camera follows the moved player, the animation is picked before it plays. Both chains are independent of each other
+	updateSystems.add("move", { playerHandle, playerMove }).reads<ControllerComponent::Keyboard>().writes<Component::Transform>();
+	updateSystems.add("camera", { playerHandle, playerCamera }).reads<Component::Transform>().writes<Component::Transform>();
+	updateSystems.add("animate move", { playerHandle, playerAnimateMove }).reads<ControllerComponent::Keyboard>().writes<System::AnimationSystem>();
+	updateSystems.add("animation", { playerHandle, playerAnimation }).reads<System::AnimationSystem>().writes<Component::Src>();
 
+	return playerHandle;
+}
 
-	Logger::message("Entities Created: " + std::to_string(Entity::count));
-	Logger::message("Components Created: " + std::to_string(IComponent::count));
+bool tick(SystemScheduler& updateSystems, InputRecording::Recorder& recorder, InputRecording::Player& player)
+{
+	PROFILE_SCOPE("tick");
 
-	GLfloat lastFrame = 0.0f;
+	// A replay overrides this tick's input and dt, a recording stores whatever they ended up being
+	if (player.isOpen() && !player.next())
+		return false;
+	recorder.record();
 
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Keep where everything was, rendering blends from there to the new positions
+	Game::Registry.view<Component::Transform>().each([](Component::Transform& transform) { transform.snapshot(); });
 
-	// Game loop
-	while (!glfwWindowShouldClose(window)) {
-		// calculate delta time
-		const auto currentFrame = static_cast<GLfloat>(glfwGetTime());
-		Game::DeltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
-		/////////////////////////////////////////////////////////////////////////////////////////////////////////
-		// INPUT
-		/////////////////////////////////////////////////////////////////////////////////////////////////////////
-		//processInput(window, playerTransform);
+	// Make updates to live entities, systems of destroyed or inactive entities are skipped
+	updateSystems.run();
+	Game::Time += Game::FixedDeltaTime;
 
-		/////////////////////////////////////////////////////////////////////////////////////////////////////////
-		// UPDATE
-		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	return true;
+}
 
-		// Make updates to live entities
-		for (const auto update : updateSystems) {
-			update->execute();
+Options parseOptions(const int argc, char* argv[])
+{
+	// --headless [ticks]	runs the update systems without a window or OpenGL, as fast as possible
+	// --record <file>		records the input of every tick to file
+	// --replay <file>		replays the input recorded in file, then exits
+	// --profile <file>		times the frame, systems and renderer and writes file.json (Chrome trace) and file.csv (per frame timings)
+	// --stream <mode>		how the renderer streams vertices: persistent (mapped buffer, the default) or orphan (glBufferSubData)
+	// --quads <mode>		how the renderer draws quads: indexed (4 vertices, the default), triangles (6 vertices) or instanced (1 instance)
+	// --texture-slots <n>	textures one batch can hold (1 to 8, the default), 1 flushes on every texture switch
+	// --unsorted			draws sprites in the order the render systems queue them instead of sorting them by render group and state
+	Options options;
+
+	for (auto i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		const auto        hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+
+		if (arg == "--headless") {
+			options.headless = true;
+			if (hasValue) {
+				const auto ticks = std::strtoull(argv[++i], nullptr, 10);
+				if (ticks)
+					options.ticks = static_cast<std::size_t>(ticks);
+			}
 		}
+		else if (arg == "--record" && hasValue)
+			options.record = argv[++i];
+		else if (arg == "--replay" && hasValue)
+			options.replay = argv[++i];
+		else if (arg == "--profile" && hasValue)
+			options.profile = argv[++i];
+#ifndef HEADLESS_ONLY
+		else if (arg == "--stream" && hasValue) {
+			const std::string mode = argv[++i];
+			if (mode == "orphan")
+				options.streaming = Component::Renderer::Streaming::Orphan;
+			else if (mode != "persistent")
+				Logger::warning("Unknown stream mode: " + mode, Logger::SEVERITY::LOW);
+		}
+		else if (arg == "--quads" && hasValue) {
+			const std::string mode = argv[++i];
+			if (mode == "triangles")
+				options.quadMode = Component::Renderer::QuadMode::Triangles;
+			else if (mode == "instanced")
+				options.quadMode = Component::Renderer::QuadMode::Instanced;
+			else if (mode != "indexed")
+				Logger::warning("Unknown quad mode: " + mode, Logger::SEVERITY::LOW);
+		}
+		else if (arg == "--unsorted")
+			options.sortDraws = false;
+		else if (arg == "--texture-slots" && hasValue) {
+			const auto slots = std::strtoul(argv[++i], nullptr, 10);
+			if (slots >= 1u && slots <= Component::Renderer::MAX_TEXTURE_SLOTS)
+				options.textureSlots = static_cast<unsigned int>(slots);
+			else
+				Logger::warning("Texture slots must be between 1 and " + std::to_string(Component::Renderer::MAX_TEXTURE_SLOTS), Logger::SEVERITY::LOW);
+		}
+#endif
+		else
+			Logger::warning("Unknown command line option: " + arg, Logger::SEVERITY::LOW);
+	}
 
-		/////////////////////////////////////////////////////////////////////////////////////////////////////////
-		// DRAW
-		/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	return options;
+}
 
-		// Clears screen to black
-		renderComponent.clear();
+int runHeadless(const Options& options)
+{
+	InputRecording::Recorder recorder;
+	InputRecording::Player   player;
+	if (!options.record.empty())
+		recorder.open(options.record);
+	if (!options.replay.empty() && !player.open(options.replay))
+		return -1;
 
-		// Begin batch drawing
-		renderComponent.beginDraw();
+	// A replay runs for as long as it was recorded
+	const auto ticks = player.isOpen() ? static_cast<std::size_t>(player.ticks()) : options.ticks;
+	Logger::message("Starting Application (Headless, " + std::to_string(ticks) + " ticks)");
 
-		// Make draw calls to renderer
-		for (const auto draw : renderSystems) {
-			draw->execute();
-		}
+	// Nothing is drawn, so there is no window, OpenGL context, renderer or render systems. Only the update systems run
+	SystemScheduler updateSystems(Game::Registry, *Game::Jobs);
+	updateSystems.setSerial(SERIAL_SYSTEMS);
 
-		// End batch drawing
-		renderComponent.endDraw();
+	const auto controller          = new Entity();
+	auto&      controllerComponent = *controller->addComponent<ControllerComponent::Keyboard>();
 
-		renderComponent.display();
+	const auto cameraHandle    = Game::Registry.create();
+	auto&      cameraTransform = *Game::Registry.addComponent<Component::Transform>(cameraHandle, 0.f, 0.f, ROWS * Game::TileSize);
 
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+	// Animation frames only need the sprite sheet's dimensions, read them without loading the texture
+	int fleshWidth = 0, fleshHeight = 0, fleshChannels = 0;
+	if (!stbi_info(FLESH_PATH, &fleshWidth, &fleshHeight, &fleshChannels)) {
+		Logger::error("Failed to read texture info: " + std::string(FLESH_PATH), Logger::SEVERITY::MEDIUM);
+		fleshWidth = static_cast<int>(Game::TileSize);
 	}
 
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// CLEAN-UP
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////
-	glfwTerminate();
-	// delete entities and their components
-	delete player;
-	delete camera;
-	delete tileMap;
-	delete shaders;
-	delete textures;
-	delete renderer;
+	const auto animation = new Entity();
+	createPlayer(updateSystems, controllerComponent, cameraTransform, *animation, std::max(fleshWidth / 64, 1));
+
+	Game::FixedDeltaTime = 1.0f / Game::TickRate;
+	Game::DeltaTime      = Game::FixedDeltaTime;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::size_t ran = 0;
+	for (; ran < ticks; ++ran) {
+		if (!player.isOpen())
+			scriptInput(ran);
+
+		if (!tick(updateSystems, recorder, player))
+			break;
+
+		Game::Registry.flush();
+
+		// Every tick is a frame of its own
+		Profiler::endFrame();
+	}
+
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const auto rate    = seconds > 0.0 ? static_cast<double>(ran) / seconds : 0.0;
+
+	std::cout << ran << " ticks in " << seconds << " s (" << rate << " ticks/sec)\n";
+	updateSystems.report();
+	writeProfile(options);
+
+	Game::Registry.clear();
 	delete controller;
 	delete animation;
+	delete Game::Global;
+	Game::Global = nullptr;
 
+	return checkLeaks();
+}
+
+void writeProfile(const Options& options)
+{
+	if (options.profile.empty())
+		return;
+
+	Profiler::writeTrace(options.profile + ".json");
+	Profiler::writeCsv(options.profile + ".csv");
+}
+
+int checkLeaks()
+{
 	if (Entity::count) {
 		std::cerr << "Entity Memory Leak: " << Entity::count << std::endl;
 		return -1;
@@ -337,6 +666,7 @@ int main()
 	return 0;
 }
 
+#ifndef HEADLESS_ONLY
 void keyCallback(GLFWwindow* window, int key, int scanCode, int action, int mode)
 {
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
@@ -372,7 +702,24 @@ void processInput(GLFWwindow* window, Component::Transform& transform)
 		rect.x -= SPEED;
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
 }
+#endif
+
+void scriptInput(const std::size_t tick)
+{
+	// Walk right, down, left, up and diagonally for two seconds each, then stand still for two, over and over
+	constexpr std::size_t PHASE_TICKS = 120;
+	using Key = ControllerComponent::Keyboard;
+	constexpr int         PHASES[][2] = { { Key::Right, 0 }, { Key::Down, 0 }, { Key::Left, 0 }, { Key::Up, 0 }, { Key::Right, Key::Down }, { 0, 0 } };
+
+	const auto& phase = PHASES[tick / PHASE_TICKS % std::size(PHASES)];
+
+	Game::keys.fill(false);
+	for (const auto key : phase)
+		if (key)
+			Game::keys[key] = true;
+}
 
+#ifndef HEADLESS_ONLY
 void framebufferSizeCallback(GLFWwindow* window, const int width, const int height)
 {
 	glViewport(0, 0, width, height);
@@ -447,3 +794,4 @@ void APIENTRY glDebugOutput(const GLenum       source,
 
 	Logger::error(ss.str(), Logger::SEVERITY::HIGH);
 }
+#endif
@@ -0,0 +1,3 @@
+// stb_image's implementation lives in a translation unit of its own, so headless builds can read image sizes without the texture code
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
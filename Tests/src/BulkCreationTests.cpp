@@ -0,0 +1,109 @@
+#include "Test.h"
+
+#include "Archetype.h"
+#include "Entity.h"
+
+#include "Components/RectComponent.h"
+#include "Components/TransformComponent.h"
+
+#include <tuple>
+
+namespace
+{
+	constexpr std::size_t LAYER_SIZE  = 1024u;	// tiles along each side of the archetype layer
+	constexpr std::size_t ENTITY_SIZE = 256u;	// tiles along each side of the entity layer, every tile costs two pooled components there
+	constexpr float       TILE        = 64.f;
+	constexpr std::size_t RUNS        = 3u;
+
+	using TileArchetype = Archetype<Component::Transform, Component::Src>;
+
+	// Row major tile i, laid out as main.cpp does for the tile map
+	auto tileArgs(const std::size_t i, const std::size_t size)
+	{
+		return std::make_tuple(std::make_tuple(static_cast<float>(i % size) * TILE, static_cast<float>(i / size) * TILE, TILE),
+							   std::make_tuple(0.f, 0.f, TILE, TILE));
+	}
+}
+
+TEST(bulkTileLayer)
+{
+	constexpr auto tiles = LAYER_SIZE * LAYER_SIZE;
+
+	// Best of RUNS, alternating so neither path always pays for first touching the memory
+	auto singleMs = 0.0, bulkMs = 0.0;
+	std::size_t allocations = 0;
+	for (std::size_t run = 0; run < RUNS; ++run) {
+		// One row at a time, growing chunk by chunk
+		{
+			TileArchetype single;
+			Test::Timer timer;
+			for (std::size_t i = 0; i < tiles; ++i)
+				std::apply([&single](auto&&... args) { single.emplace_back(args...); }, tileArgs(i, LAYER_SIZE));
+			const auto ms = timer.ms();
+
+			CHECK(single.size() == tiles);
+			singleMs = run ? std::min(singleMs, ms) : ms;
+		}
+
+		// Every chunk allocated up front, then filled in place
+		TileArchetype bulk;
+		const auto allocationsBefore = Test::allocations();
+		Test::Timer timer;
+		bulk.createMany(tiles, [](const std::size_t i) { return tileArgs(i, LAYER_SIZE); });
+		const auto ms = timer.ms();
+		allocations = Test::allocations() - allocationsBefore;
+
+		CHECK(bulk.size() == tiles);
+		CHECK(allocations <= bulk.chunkCount() + 1u);	// the chunks and the chunk table, nothing per tile
+		for (const auto i : { std::size_t{ 0 }, LAYER_SIZE + 1u, tiles - 1u }) {
+			CHECK(bulk.get<Component::Transform>(i).x == static_cast<float>(i % LAYER_SIZE) * TILE);
+			CHECK(bulk.get<Component::Transform>(i).y == static_cast<float>(i / LAYER_SIZE) * TILE);
+			CHECK(bulk.get<Component::Src>(i).w == TILE);
+		}
+		bulkMs = run ? std::min(bulkMs, ms) : ms;
+	}
+
+	Test::report(std::to_string(LAYER_SIZE) + "x" + std::to_string(LAYER_SIZE) + " archetype layer: createMany " + std::to_string(bulkMs) +
+				 " ms (" + std::to_string(allocations) + " allocations), emplace_back loop " + std::to_string(singleMs) + " ms");
+}
+
+TEST(bulkEntityComponents)
+{
+	constexpr auto tiles = ENTITY_SIZE * ENTITY_SIZE;
+	static_assert(sizeof(Component::Src) == sizeof(Component::Dest), "the layer needs two columns drawing from the same pool");
+
+	Entity single;
+	Test::Timer timer;
+	for (std::size_t i = 0; i < tiles; ++i) {
+		single.push_back<Component::Transform>(static_cast<float>(i % ENTITY_SIZE) * TILE, static_cast<float>(i / ENTITY_SIZE) * TILE, TILE);
+		single.push_back<Component::Src>(0.f, 0.f, TILE, TILE);
+		single.push_back<Component::Dest>(0.f, 0.f, TILE, TILE);
+	}
+	const auto singleMs = timer.ms();
+
+	// What sizing the component storage for the layer allocates on its own, on whichever storage this build uses
+	Entity probe;
+	auto allocationsBefore = Test::allocations();
+	probe.reserve(tiles * 3u);
+	const auto storageAllocations = Test::allocations() - allocationsBefore;
+
+	// Src and Dest share a pool, so it has to be reserved for both at once or half of them grow it slab by slab
+	Entity bulk;
+	allocationsBefore = Test::allocations();
+	timer.reset();
+	bulk.createMany<Component::Transform, Component::Src, Component::Dest>(tiles, [](const std::size_t i)
+	{
+		return std::tuple_cat(tileArgs(i, ENTITY_SIZE), std::make_tuple(std::make_tuple(0.f, 0.f, TILE, TILE)));
+	});
+	const auto bulkMs      = timer.ms();
+	const auto allocations = Test::allocations() - allocationsBefore;
+
+	CHECK(bulk.componentsSize() == tiles * 3u);
+	CHECK(single.componentsSize() == tiles * 3u);
+	CHECK(bulk.getComponentList<Component::Transform>().size() == tiles);
+	CHECK(bulk.getComponentList<Component::Transform>().back()->y == static_cast<float>(ENTITY_SIZE - 1u) * TILE);
+	CHECK(allocations <= storageAllocations + 2u);	// the storage and one slab per pool (Transform's, and Src and Dest's), nothing per tile
+
+	Test::report(std::to_string(ENTITY_SIZE) + "x" + std::to_string(ENTITY_SIZE) + " entity layer: createMany " + std::to_string(bulkMs) +
+				 " ms (" + std::to_string(allocations) + " allocations), push_back loop " + std::to_string(singleMs) + " ms");
+}
@@ -0,0 +1,64 @@
+#include "Test.h"
+
+#include "Entity.h"
+#include "SplayTree.h"
+#include "StringID.h"
+
+#include "Components/RectComponent.h"
+#include "Components/TransformComponent.h"
+
+namespace
+{
+	constexpr std::size_t ACCESSES = 1000000u;
+}
+
+TEST(componentAccessByTypeTag)
+{
+	Entity entity;
+	const auto transform = entity.addComponent<Component::Transform>(1.f, 2.f, 64.f);
+	const auto src       = entity.addIDComponent<Component::Src>("src"_sid, 0.f, 0.f, 64.f, 64.f);
+	entity.push_back<Component::Transform>(3.f, 4.f, 64.f);
+	entity.push_back<Component::Src>(0.f, 64.f, 64.f, 64.f);
+	entity.push_back<Component::Transform>(5.f, 6.f, 64.f);
+
+	CHECK(entity.getComponent<Component::Transform>() == transform);
+	CHECK(entity.get_component<Component::Src>("src"_sid) == src);
+	CHECK(entity.getComponent<IComponent>(static_cast<int>(getComponentTypeID<Component::Transform>())) == transform);
+
+	// Lists only hold components stored with their type's tag
+	CHECK(entity.getComponentList<Component::Transform>().size() == 3u);
+	CHECK(entity.getComponentList<Component::Src>().size() == 2u);
+	CHECK(entity.getComponentList<IComponent>().size() == 5u);
+	for (const auto listed : entity.getComponentList<Component::Transform>())
+		CHECK(dynamic_cast<Component::Transform*>(static_cast<IComponent*>(listed)) == listed);
+
+	// The same components in the storage and lookup getComponent used before tags: a SplayTree, splayed by every search, then dynamic_cast
+	const auto id = static_cast<int>(getComponentTypeID<Component::Transform>());
+	SplayTree<IComponent> splay;
+	splay.insert(id, new Component::Transform(1.f, 2.f, 64.f));
+	splay.insert(("src"_sid).value(), new Component::Src(0.f, 0.f, 64.f, 64.f));
+	splay.insert(new Component::Transform(3.f, 4.f, 64.f));
+	splay.insert(new Component::Src(0.f, 64.f, 64.f, 64.f));
+	splay.insert(new Component::Transform(5.f, 6.f, 64.f));
+	float sum = 0.f;
+
+	Test::Timer timer;
+	for (std::size_t i = 0; i < ACCESSES; ++i)
+		sum += entity.getComponent<Component::Transform>()->x;
+	const auto taggedMs = timer.ms();
+
+	timer.reset();
+	for (std::size_t i = 0; i < ACCESSES; ++i)
+		sum += dynamic_cast<Component::Transform*>(splay.search(id))->x;
+	const auto oldMs = timer.ms();
+
+	// Only the cast differs from the tagged lookup here
+	timer.reset();
+	for (std::size_t i = 0; i < ACCESSES; ++i)
+		sum += dynamic_cast<Component::Transform*>(entity.getComponent<IComponent>(id))->x;
+	const auto castMs = timer.ms();
+
+	CHECK(sum == 3.f * ACCESSES * transform->x);
+	Test::report(std::to_string(ACCESSES) + " getComponent<Transform>(): tagged " + std::to_string(taggedMs) + " ms, SplayTree + dynamic_cast (before) " +
+				 std::to_string(oldMs) + " ms, dynamic_cast cost only " + std::to_string(castMs) + " ms");
+}
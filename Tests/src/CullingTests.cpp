@@ -0,0 +1,149 @@
+#include "Test.h"
+
+#include "Game.h"
+
+#include "Components/RendererComponent.h"
+#include "Systems/RenderSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+	constexpr std::size_t FRAMES = 1000u;
+
+	// What an uploaded chunk holds: its quad count and the world space bounds of its vertices
+	struct CountedQuads
+	{
+		std::size_t quads{0};
+		float       left{0.f}, top{0.f}, right{0.f}, bottom{0.f};
+	};
+
+	struct TestMaterial
+	{
+		struct
+		{
+			int width{64}, height{64};
+		} texture;
+	};
+
+	// Stands in for Component::Renderer, counting the chunks and quads TileMapDraw uploads and draws instead of sending them to a GPU
+	struct CountingRenderer
+	{
+		std::size_t quadFloats() const { return Component::Renderer::INDEXED_QUAD_FLOATS; }
+
+		float* writeStaticQuad(float* out, const Rect& dest, const Rect& normSrc) const { return Component::Renderer::writeCorners(out, dest, normSrc); }
+
+		void upload(CountedQuads& quads, const std::vector<float>& vertices)
+		{
+			quads = CountedQuads{ vertices.size() / quadFloats(), vertices[0], vertices[1], vertices[0], vertices[1] };
+			for (std::size_t i = 0; i < vertices.size(); i += 4u) {
+				quads.left   = std::min(quads.left, vertices[i]);
+				quads.right  = std::max(quads.right, vertices[i]);
+				quads.top    = std::min(quads.top, vertices[i + 1]);
+				quads.bottom = std::max(quads.bottom, vertices[i + 1]);
+			}
+			++uploads;
+		}
+
+		void drawStatic(const CountedQuads& quads, TestMaterial&, const glm::mat4&) { drawn.push_back(&quads); }
+
+		std::vector<const CountedQuads*> drawn;	// chunks drawn this frame
+		std::size_t                      uploads{0};
+	};
+
+	using TileMapDraw = ComponentSystemRender::BasicTileMapDraw<CountingRenderer, TestMaterial, CountedQuads>;
+
+	// Chunks of a count tile long row or column overlapping [start, start + length), and the tiles they hold, counted chunk by chunk
+	std::pair<std::size_t, std::size_t> overlapping(const float start, const float length, const std::size_t count)
+	{
+		std::pair<std::size_t, std::size_t> overlap{ 0u, 0u };
+		for (std::size_t first = 0; first < count; first += TileMapDraw::CHUNK_SIZE) {
+			const auto last = std::min(first + TileMapDraw::CHUNK_SIZE, count);
+			if (static_cast<float>(first) * Game::TileSize < start + length && static_cast<float>(last) * Game::TileSize > start) {
+				++overlap.first;
+				overlap.second += last - first;
+			}
+		}
+		return overlap;
+	}
+}
+
+TEST(tileCullingStaysFlat)
+{
+	const auto tile = Game::TileSize;
+	const auto span = static_cast<float>(TileMapDraw::CHUNK_SIZE) * tile;
+
+	// Most chunks a view can overlap, wherever it sits
+	const auto maxChunks = static_cast<std::size_t>((std::floor(Game::Width / span) + 2.f) * (std::floor(Game::Height / span) + 2.f));
+
+	for (const std::size_t size : { 32u, 256u, 1024u }) {
+		ComponentSystemRender::SpriteArchetype tiles;
+		tiles.createMany(size * size, [size, tile](const std::size_t i)
+		{
+			return std::make_tuple(Rect{ static_cast<float>(i % size) * tile, static_cast<float>(i / size) * tile, tile, tile }, Rect{ 0.f, 0.f, 1.f, 1.f });
+		});
+
+		CountingRenderer     renderer;
+		TestMaterial         material;
+		Component::Transform camera(Rect{ 0.f, 0.f, Game::Width, Game::Height });
+		TileMapDraw          draw(renderer, tiles, material, camera, size, tile);
+
+		const auto mapSize = static_cast<float>(size) * tile;
+
+		// Pans diagonally off the grid lines and a little past the map's far edges
+		const auto frame = [&](const std::size_t index)
+		{
+			camera.x = std::fmod(static_cast<float>(index) * 37.3f, mapSize);
+			camera.y = std::fmod(static_cast<float>(index) * 21.7f, mapSize);
+			camera.snapshot();
+
+			renderer.drawn.clear();
+			draw.execute();
+		};
+
+		std::size_t chunks = 0, quads = 0, mostChunks = 0;
+
+		Test::Timer timer;
+		for (std::size_t i = 0; i < FRAMES; ++i) {
+			frame(i);
+			chunks += renderer.drawn.size();
+			mostChunks = std::max(mostChunks, renderer.drawn.size());
+			for (const auto drawn : renderer.drawn)
+				quads += drawn->quads;
+		}
+		const auto ms = timer.ms();
+		const auto built = renderer.uploads;
+
+		// Replaying the pan draws exactly the chunks overlapping the view with all of their tiles, and uploads nothing: every chunk is cached
+		std::size_t wrong = 0, outside = 0;
+		for (std::size_t i = 0; i < FRAMES; ++i) {
+			frame(i);
+
+			const auto cols = overlapping(camera.x, Game::Width, size);
+			const auto rows = overlapping(camera.y, Game::Height, size);
+
+			std::size_t drawnQuads = 0;
+			for (const auto drawn : renderer.drawn) {
+				drawnQuads += drawn->quads;
+				outside += drawn->right <= camera.x || drawn->left >= camera.x + Game::Width || drawn->bottom <= camera.y || drawn->top >= camera.y + Game::Height;
+			}
+			wrong += renderer.drawn.size() != cols.first * rows.first || drawnQuads != cols.second * rows.second;
+		}
+		CHECK(wrong == 0u);
+		CHECK(outside == 0u);
+		CHECK(renderer.uploads == built);
+		CHECK(mostChunks <= maxChunks);
+
+		// Only the chunk holding a changed tile is built again
+		draw.invalidate(static_cast<std::size_t>(camera.y / tile) * size + static_cast<std::size_t>(camera.x / tile));
+		draw.execute();
+		CHECK(renderer.uploads == built + 1u);
+
+		Test::report(std::to_string(size) + "x" + std::to_string(size) + " map: " + std::to_string(ms * 1000.0 / FRAMES) + " us/frame, " +
+					 std::to_string(chunks / FRAMES) + " chunks and " + std::to_string(quads / FRAMES) + " quads drawn per frame, " +
+					 std::to_string(built) + " chunks built");
+	}
+}
@@ -0,0 +1,67 @@
+#include "Test.h"
+
+#include "FlatMap.h"
+#include "SplayTree.h"
+
+#include <random>
+
+namespace
+{
+	constexpr std::size_t LOOKUPS = 1u << 20;
+
+	// Component ids are handed out program wide, so an entity's keys are sparse rather than 0..n-1
+	std::size_t componentKey(const std::size_t i)
+	{
+		return i * 7u + 3u;
+	}
+
+	// Times LOOKUPS searches for random stored keys and checks every one finds what was inserted
+	template <typename Storage>
+	double timeLookups(Storage& storage, const std::vector<int*>& values, const std::vector<std::size_t>& order)
+	{
+		std::size_t found = 0;
+
+		Test::Timer timer;
+		for (const auto i : order)
+			if (storage.search(componentKey(i)) == values[i])
+				++found;
+		const auto ms = timer.ms();
+
+		CHECK(found == order.size());
+		return ms;
+	}
+}
+
+TEST(flatMapMatchesSplayTree)
+{
+	for (std::size_t components = 1; components <= 64; components *= 2) {
+		FlatMap<int>   flat;
+		SplayTree<int> splay;
+		std::vector<int*> flatValues, splayValues;
+
+		for (std::size_t i = 0; i < components; ++i) {
+			flatValues.push_back(flat.insert(componentKey(i), new int(static_cast<int>(i)), i));
+			splayValues.push_back(splay.insert(componentKey(i), new int(static_cast<int>(i)), i));
+		}
+
+		// Lookups never write, so they go through a const map
+		const auto& reader = flat;
+		for (std::size_t i = 0; i < components; ++i) {
+			CHECK(*reader.search(componentKey(i)) == static_cast<int>(i));
+			CHECK(reader.tag(componentKey(i)) == i);
+			CHECK(*splay.search(componentKey(i)) == static_cast<int>(i));
+		}
+		CHECK(!reader.search(componentKey(components)));
+		CHECK(!splay.search(componentKey(components)));
+
+		std::mt19937 random{ static_cast<unsigned>(components) };
+		std::vector<std::size_t> order(LOOKUPS);
+		for (auto& i : order)
+			i = random() % components;
+
+		const auto flatMs  = timeLookups(flat, flatValues, order);
+		const auto splayMs = timeLookups(splay, splayValues, order);
+		Test::report(std::to_string(components) + " components, " + std::to_string(LOOKUPS) + " lookups: FlatMap " + std::to_string(flatMs) +
+					 " ms, SplayTree " + std::to_string(splayMs) + " ms");
+	}
+}
@@ -0,0 +1,78 @@
+#include "Test.h"
+
+#include "Archetype.h"
+#include "JobSystem.h"
+
+#include "Components/TransformComponent.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <tuple>
+
+namespace
+{
+	constexpr std::size_t TRANSFORMS = 1000000u;
+	constexpr std::size_t GRAIN      = 4096u;
+	constexpr std::size_t PASSES     = 10u;
+
+	using Transforms = Archetype<Component::Transform>;
+
+	void fill(Transforms& transforms)
+	{
+		transforms.clear();
+		transforms.createMany(TRANSFORMS, [](const std::size_t i)
+		{
+			return std::make_tuple(std::make_tuple(static_cast<float>(i % 1024u) * 64.f, static_cast<float>(i / 1024u) * 64.f, 64.f));
+		});
+	}
+
+	// A movement step with enough math per transform that the loop isn't bound by memory alone
+	void step(const std::size_t count, Component::Transform* transforms)
+	{
+		for (std::size_t i = 0; i < count; ++i) {
+			auto& transform = transforms[i];
+			transform.snapshot();
+			transform.x += std::cos(transform.y * 0.01f) * 4.f;
+			transform.y += std::sin(transform.x * 0.01f) * 4.f;
+		}
+	}
+}
+
+TEST(parallelForSpeedup)
+{
+	Transforms reference, transforms;
+	fill(reference);
+	for (std::size_t pass = 0; pass < PASSES; ++pass)
+		reference.eachChunk(step);
+
+	const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+	double oneCoreMs = 0.0;
+
+	for (auto threads = 1u;; threads = std::min(threads * 2u, cores)) {
+		JobSystem jobs(threads);
+		fill(transforms);
+
+		Test::Timer timer;
+		for (std::size_t pass = 0; pass < PASSES; ++pass)
+			jobs.parallel_for(0, transforms.size(), GRAIN, [&transforms](const std::size_t begin, const std::size_t end) { transforms.eachRange(begin, end, step); });
+		const auto ms = timer.ms();
+
+		// Every transform was stepped exactly PASSES times, whichever thread ran it
+		std::size_t matching = 0;
+		for (std::size_t i = 0; i < TRANSFORMS; ++i) {
+			const auto& expected = reference.get<Component::Transform>(i);
+			const auto& actual   = transforms.get<Component::Transform>(i);
+			matching += actual.x == expected.x && actual.y == expected.y;
+		}
+		CHECK(matching == TRANSFORMS);
+
+		if (threads == 1u)
+			oneCoreMs = ms;
+		Test::report(std::to_string(threads) + " threads: " + std::to_string(PASSES) + " x " + std::to_string(TRANSFORMS) + " transforms in " +
+					 std::to_string(ms) + " ms (" + std::to_string(oneCoreMs / ms) + "x)");
+
+		if (threads == cores)
+			break;
+	}
+}
@@ -0,0 +1,107 @@
+#include "Test.h"
+
+#include "Sort.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <set>
+
+namespace
+{
+	constexpr std::size_t   SPRITES  = 100000u;
+	constexpr std::size_t   RUNS     = 20u;
+	constexpr std::uint32_t GROUPS   = 3u;
+	constexpr std::uint32_t SHADERS  = 4u;
+	constexpr std::uint32_t TEXTURES = 16u;
+
+	// Same layout as RenderQueue's entries, which can't be built here without GL materials
+	struct Entry
+	{
+		std::uint64_t key;
+		std::uint32_t command;
+	};
+
+	std::uint32_t orderedBits(const float value)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+	}
+
+	// RenderQueue::key: group (8 bits), shader (12), texture (12), depth (32)
+	std::uint64_t key(const std::uint32_t group, const std::uint32_t shader, const std::uint32_t texture, const float depth)
+	{
+		return static_cast<std::uint64_t>(group) << 56
+			   | static_cast<std::uint64_t>(shader & 0xFFFu) << 44
+			   | static_cast<std::uint64_t>(texture & 0xFFFu) << 32
+			   | orderedBits(depth);
+	}
+
+	// Draw calls the renderer would flush: one per run of entries sharing group, shader and texture
+	std::size_t batches(const std::vector<Entry>& entries)
+	{
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < entries.size(); ++i)
+			count += !i || entries[i].key >> 32 != entries[i - 1].key >> 32;
+		return count;
+	}
+
+	// Best time of RUNS sorts of a fresh copy of entries with sort
+	template <typename Sort>
+	double bestOf(const std::vector<Entry>& entries, std::vector<Entry>& sorted, Sort sort)
+	{
+		auto best = 0.0;
+		for (std::size_t run = 0; run < RUNS; ++run) {
+			sorted = entries;
+			Test::Timer timer;
+			sort(sorted);
+			const auto ms = timer.ms();
+
+			Test::keep(sorted.data());
+			best = run ? std::min(best, ms) : ms;
+		}
+		return best;
+	}
+}
+
+TEST(renderQueueSort)
+{
+	std::mt19937 random{ 24u };
+	std::uniform_int_distribution<std::uint32_t> group{ 0u, GROUPS - 1u }, shader{ 1u, SHADERS }, texture{ 1u, TEXTURES };
+	std::uniform_real_distribution<float> depth{ -512.f, 2048.f };
+
+	// Coarse depths so plenty of entries share a key and stability shows
+	std::vector<Entry> entries;
+	std::vector<float> depths;
+	std::set<std::uint64_t> states;
+	for (std::uint32_t i = 0; i < SPRITES; ++i) {
+		depths.push_back(static_cast<float>(static_cast<int>(depth(random))));
+		entries.push_back(Entry{ key(group(random), shader(random), texture(random), depths.back()), i });
+		states.insert(entries.back().key >> 32);
+	}
+
+	std::vector<Entry> radixSorted, stableSorted, scratch;
+	const auto radixMs  = bestOf(entries, radixSorted, [&scratch](std::vector<Entry>& vec) { radixSort(vec, scratch, [](const Entry& entry) { return entry.key; }); });
+	const auto stableMs = bestOf(entries, stableSorted, [](std::vector<Entry>& vec) { std::stable_sort(vec.begin(), vec.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; }); });
+
+	// Same order as a stable comparison sort, equal keys included
+	CHECK(radixSorted.size() == stableSorted.size());
+	CHECK(std::equal(radixSorted.begin(), radixSorted.end(), stableSorted.begin(), [](const Entry& a, const Entry& b) { return a.key == b.key && a.command == b.command; }));
+
+	// Within a state sprites go by depth, negative depths below positive ones
+	std::size_t misordered = 0;
+	for (std::size_t i = 1; i < radixSorted.size(); ++i)
+		if (radixSorted[i].key >> 32 == radixSorted[i - 1].key >> 32)
+			misordered += depths[radixSorted[i].command] < depths[radixSorted[i - 1].command];
+	CHECK(misordered == 0u);
+
+	// Sorted, every state is drawn in a single batch
+	const auto pushedBatches = batches(entries);
+	const auto sortedBatches = batches(radixSorted);
+	CHECK(sortedBatches == states.size());
+	CHECK(sortedBatches < pushedBatches);
+
+	Test::report(std::to_string(SPRITES) + " commands: radix sort " + std::to_string(radixMs) + " ms, std::stable_sort " + std::to_string(stableMs) + " ms, draw calls " +
+				 std::to_string(pushedBatches) + " pushed / " + std::to_string(sortedBatches) + " sorted");
+}
@@ -0,0 +1,97 @@
+#include "Test.h"
+
+#include "SplayTree.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+	constexpr std::size_t STRESS_KEYS     = 1000000u;
+	constexpr std::size_t SEQUENTIAL_KEYS = 100000u;
+}
+
+TEST(splayTreeInsertRemoveStress)
+{
+	SplayTree<std::size_t> tree;
+
+	std::vector<std::size_t> keys(STRESS_KEYS);
+	for (std::size_t i = 0; i < keys.size(); ++i)
+		keys[i] = i * 2u;	// even keys, odd ones are never stored
+	std::shuffle(keys.begin(), keys.end(), std::mt19937{ 6u });
+
+	Test::Timer timer;
+	for (const auto key : keys)
+		tree.insert(key, new std::size_t(key));
+	const auto insertMs  = timer.ms();
+	const auto peak      = tree.capacity();
+	const auto peakBytes = tree.memoryUsage();
+
+	CHECK(tree.size() == STRESS_KEYS);
+
+	// Remove every other key in a different random order, the rest must survive
+	std::shuffle(keys.begin(), keys.end(), std::mt19937{ 7u });
+	timer.reset();
+	for (std::size_t i = 0; i < keys.size(); i += 2)
+		tree.remove(keys[i]);
+	const auto removeMs = timer.ms();
+
+	CHECK(tree.size() == STRESS_KEYS / 2);
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		const auto value = tree.search(keys[i]);
+		CHECK(i % 2 ? value && *value == keys[i] : !value);
+		CHECK(!tree.search(keys[i] + 1u));
+	}
+
+	// Auto keys come from a counter, so they never land on a key that is still stored, and removed nodes are reused
+	for (std::size_t i = 0; i < STRESS_KEYS / 2; ++i) {
+		const auto value = new std::size_t(i);
+		CHECK(tree.insert(value) == value);
+	}
+	CHECK(tree.size() == STRESS_KEYS);
+	CHECK(tree.capacity() == peak);
+	CHECK(tree.memoryUsage() == peakBytes);
+
+	// Only the auto keyed values are left once the surviving keys go
+	for (std::size_t i = 1; i < keys.size(); i += 2)
+		tree.remove(keys[i]);
+	CHECK(tree.size() == STRESS_KEYS / 2);
+
+	const auto ops = static_cast<double>(STRESS_KEYS + STRESS_KEYS / 2);
+	Test::report(std::to_string(STRESS_KEYS) + " inserts in " + std::to_string(insertMs) + " ms, " + std::to_string(STRESS_KEYS / 2) +
+				 " removes in " + std::to_string(removeMs) + " ms (" + std::to_string(ops / (insertMs + removeMs) / 1000.0) + " M ops/s)");
+	Test::report("peak memory: " + std::to_string(static_cast<double>(peakBytes) / (1024.0 * 1024.0)) + " MB (" + std::to_string(peak) + " pooled nodes, " +
+				 std::to_string(static_cast<double>(peakBytes) / STRESS_KEYS) + " bytes per key) for " + std::to_string(STRESS_KEYS) + " keys");
+}
+
+TEST(splayTreeSequentialKeys)
+{
+	SplayTree<std::size_t> tree;
+
+	// Keys handed out in order, as push_back does for tiles, leave the tree a single left leaning path
+	Test::Timer timer;
+	for (std::size_t i = 0; i < SEQUENTIAL_KEYS; ++i)
+		tree.insert(new std::size_t(i));
+	const auto insertMs = timer.ms();
+
+	// The first key sits at the bottom of that path, a recursive splay would be SEQUENTIAL_KEYS calls deep here
+	CHECK(tree.search(0u) && *tree.search(0u) == 0u);
+	CHECK(tree.search(SEQUENTIAL_KEYS - 1u) && *tree.search(SEQUENTIAL_KEYS - 1u) == SEQUENTIAL_KEYS - 1u);
+
+	std::vector<std::size_t> order(SEQUENTIAL_KEYS);
+	for (std::size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::shuffle(order.begin(), order.end(), std::mt19937{ 8u });
+
+	std::size_t found = 0;
+	timer.reset();
+	for (const auto key : order)
+		if (const auto value = tree.search(key); value && *value == key)
+			++found;
+	const auto searchMs = timer.ms();
+
+	CHECK(found == SEQUENTIAL_KEYS);
+	CHECK(tree.size() == SEQUENTIAL_KEYS);
+	Test::report(std::to_string(SEQUENTIAL_KEYS) + " sequential inserts in " + std::to_string(insertMs) + " ms, random searches in " +
+				 std::to_string(searchMs) + " ms");
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+Minimal test and benchmark runner for the engine, built by the Tests project without a window or OpenGL.
+TEST(name) registers a test, CHECK(expression) records a failure and lets the test carry on. Benchmarks time their loops with
+Test::Timer and print their figures through Test::report, build Release for numbers that mean anything.
+
+	TEST(flatMapLookup)
+	{
+		Test::Timer timer;
+		...
+		CHECK(found == count);
+		Test::report("lookups: " + std::to_string(timer.ms()) + " ms");
+	}
+*/
+namespace Test
+{
+	using Function = void (*)();
+
+	struct Case
+	{
+		const char* name;
+		Function    function;
+	};
+
+	// Every registered test in registration order
+	std::vector<Case>& cases();
+
+	void fail(const char* expression, const char* file, int line);
+	void report(const std::string& line);
+
+	// Written by keep(), defined by the runner so the compiler can't prove the writes unused
+	extern const void* volatile sink;
+
+	// Global operator new calls made so far by every thread, the runner replaces operator new to count them
+	std::size_t allocations();
+
+	/* Registers a test during static initialization */
+	struct Registrar
+	{
+		Registrar(const char* name, const Function function)
+		{
+			cases().push_back(Case{ name, function });
+		}
+	};
+
+	/* Wall clock time since construction or the last reset */
+	class Timer
+	{
+	public:
+		void reset() { m_start = std::chrono::steady_clock::now(); }
+
+		double ms() const { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count(); }
+
+	private:
+		std::chrono::steady_clock::time_point m_start{ std::chrono::steady_clock::now() };
+	};
+
+	// Keeps the optimizer from dropping a benchmark loop whose result is otherwise unused
+	template <typename T>
+	void keep(const T& value)
+	{
+		sink = &value;
+	}
+}
+
+#define TEST(name)                                                        \
+	static void name();                                                   \
+	static const Test::Registrar name##Registrar{ #name, name };          \
+	static void name()
+
+#define CHECK(expression) ((expression) ? static_cast<void>(0) : Test::fail(#expression, __FILE__, __LINE__))
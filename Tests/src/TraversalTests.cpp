@@ -0,0 +1,136 @@
+#include "Test.h"
+
+#include "Entity.h"
+#include "EntityRegistry.h"
+#include "SplayTree.h"
+
+#include "Components/RectComponent.h"
+#include "Components/TransformComponent.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+	constexpr std::size_t CHILDREN = 256u;
+	constexpr std::size_t FRAMES   = 10u;
+
+	constexpr std::size_t SMALL_TREE = 5000u;
+	constexpr std::size_t LARGE_TREE = 80000u;
+	constexpr std::size_t WALKS      = 5u;
+
+	// Best time of WALKS in-order walks over children, per child, in nanoseconds
+	double walkTime(const SplayTree<Entity>& children, const std::size_t count)
+	{
+		auto best = 0.0;
+		for (std::size_t walk = 0; walk < WALKS; ++walk) {
+			std::size_t visited = 0;
+			Test::Timer timer;
+			children.forEach([&visited](Entity* child) { visited += child != nullptr; });
+			const auto ms = timer.ms();
+
+			CHECK(visited == count);
+			best = walk ? std::min(best, ms) : ms;
+		}
+		return best * 1e6 / static_cast<double>(count);
+	}
+}
+
+TEST(traversalAllocatesNothing)
+{
+	// A scene of children holding a transform and a couple of srcs each, plus the same sprites in a registry
+	Entity         scene;
+	EntityRegistry registry;
+	for (std::size_t i = 0; i < CHILDREN; ++i) {
+		const auto child = scene.push_back_child(new Entity());
+		child->push_back<Component::Transform>(static_cast<float>(i), 0.f, 64.f);
+		child->push_back<Component::Src>(0.f, 0.f, 64.f, 64.f);
+		child->push_back<Component::Src>(64.f, 0.f, 64.f, 64.f);
+
+		const auto handle = registry.create();
+		registry.addComponent<Component::Transform>(handle, static_cast<float>(i), 0.f, 64.f);
+		registry.addComponent<Component::Src>(handle, 0.f, 0.f, 64.f, 64.f);
+	}
+
+	float sum = 0.f;
+	std::size_t srcs = 0, sprites = 0;
+	const auto frame = [&]
+	{
+		scene.forEachChild([&](Entity& child)
+		{
+			child.forEachComponent<Component::Transform>([&](Component::Transform& transform) { sum += transform.x; });
+		});
+		for (auto& child : scene.children())
+			for (auto& src : child.components<Component::Src>())
+				srcs += src.w > 0.f;
+		registry.view<Component::Transform, Component::Src>().each([&](Component::Transform& transform, Component::Src&) { sum += transform.x; ++sprites; });
+	};
+
+	// The first frame builds the view's match set, every later one only reads
+	frame();
+
+	const auto before = Test::allocations();
+	for (std::size_t i = 0; i < FRAMES; ++i)
+		frame();
+	const auto steady = Test::allocations() - before;
+
+	CHECK(steady == 0u);
+	CHECK(srcs == CHILDREN * 2u * (FRAMES + 1u));
+	CHECK(sprites == CHILDREN * (FRAMES + 1u));
+
+	// The list getters still build a vector, which is what the counter has to catch
+	const auto listBefore = Test::allocations();
+	CHECK(scene.getChildList().size() == CHILDREN);
+	CHECK(Test::allocations() > listBefore);
+
+	Test::keep(sum);
+	Test::report(std::to_string(FRAMES) + " steady frames over " + std::to_string(CHILDREN) + " children: " + std::to_string(steady) + " allocations");
+}
+
+TEST(splayTraversalOfPushedBackChildren)
+{
+	// push_back_child under ENTITY_SPLAY_STORAGE: keys handed out in order leave the tree one long left path, the worst shape to walk
+	SplayTree<Entity> small, large;
+	for (std::size_t i = 0; i < SMALL_TREE; ++i)
+		small.insert(new Entity());
+	for (std::size_t i = 0; i < LARGE_TREE; ++i)
+		large.insert(new Entity());
+
+	// A walk costs O(1) per child whatever the size, a search per step would make the large tree's children far more expensive
+	const auto smallNs = walkTime(small, SMALL_TREE);
+	const auto largeNs = walkTime(large, LARGE_TREE);
+	CHECK(largeNs < smallNs * 4.0);
+
+	// Every key in order, even with searches rotating the tree between steps
+	std::mt19937 random{ 8u };
+	std::uniform_int_distribution<std::size_t> key{ 0u, LARGE_TREE - 1u };
+	std::size_t expected = 0, misordered = 0;
+	for (auto it = large.begin(); it != large.end(); ++it, ++expected) {
+		misordered += it.key() != expected;
+		large.search(key(random));
+	}
+	CHECK(expected == LARGE_TREE);
+	CHECK(misordered == 0u);
+
+	// And after removals have relinked it
+	for (std::size_t i = 0; i < LARGE_TREE; i += 3)
+		large.remove(i);
+	expected = 1;
+	misordered = 0;
+	for (auto it = large.begin(); it != large.end(); ++it, expected += expected % 3 == 2 ? 2 : 1)
+		misordered += it.key() != expected;
+	CHECK(misordered == 0u);
+	CHECK(large.getOrderedList().size() == LARGE_TREE - (LARGE_TREE + 2) / 3);
+
+	// Same through Entity, on whichever storage this build uses
+	Entity scene;
+	for (std::size_t i = 0; i < LARGE_TREE; ++i)
+		scene.push_back_child(new Entity());
+	std::size_t children = 0;
+	scene.forEachChild([&children](Entity&) { ++children; });
+	CHECK(children == LARGE_TREE);
+	CHECK(scene.getChildList().size() == LARGE_TREE);
+
+	Test::report("in-order walk: " + std::to_string(smallNs) + " ns per child over " + std::to_string(SMALL_TREE) + " children, " + std::to_string(largeNs) +
+				 " ns over " + std::to_string(LARGE_TREE));
+}
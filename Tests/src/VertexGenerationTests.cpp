@@ -0,0 +1,63 @@
+#include "Test.h"
+
+#include "Components/RendererComponent.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+	constexpr std::size_t SPRITES = 100000u;
+	constexpr std::size_t RUNS    = 20u;
+	constexpr std::size_t VERTEX_FLOATS = 4u;
+
+	using Renderer = Component::Renderer;
+
+	// Best time of RUNS writes of every sprite with write
+	template <typename Write>
+	double bestOf(std::vector<float>& vertices, const std::vector<Rect>& dests, const std::vector<Rect>& srcs, Write write)
+	{
+		auto best = 0.0;
+		for (std::size_t run = 0; run < RUNS; ++run) {
+			Test::Timer timer;
+			auto out = vertices.data();
+			for (std::size_t i = 0; i < SPRITES; ++i)
+				out = write(out, dests[i], srcs[i]);
+			const auto ms = timer.ms();
+
+			Test::keep(*out);
+			best = run ? std::min(best, ms) : ms;
+		}
+		return best;
+	}
+}
+
+TEST(indexedVertexGeneration)
+{
+	std::mt19937 random{ 21u };
+	std::uniform_real_distribution<float> position{ 0.f, 2048.f }, coordinate{ 0.f, 1.f };
+
+	std::vector<Rect> dests, srcs;
+	for (std::size_t i = 0; i < SPRITES; ++i) {
+		dests.emplace_back(position(random), position(random), 64.f, 64.f);
+		srcs.emplace_back(coordinate(random), coordinate(random), 0.125f, 0.125f);
+	}
+
+	std::vector<float> triangles(SPRITES * Renderer::TRIANGLE_QUAD_FLOATS), corners(SPRITES * Renderer::INDEXED_QUAD_FLOATS);
+	const auto trianglesMs = bestOf(triangles, dests, srcs, [](float* out, const Rect& dest, const Rect& src) { return Renderer::writeTriangles(out, dest, src); });
+	const auto cornersMs   = bestOf(corners, dests, srcs, [](float* out, const Rect& dest, const Rect& src) { return Renderer::writeCorners(out, dest, src); });
+
+	// Corners read through the index pattern give back the exact vertices of the triangle list
+	std::size_t mismatched = 0;
+	for (std::size_t quad = 0; quad < SPRITES; ++quad)
+		for (std::size_t i = 0; i < Renderer::QUAD_INDICES.size(); ++i) {
+			const auto triangle = triangles.data() + (quad * Renderer::QUAD_INDICES.size() + i) * VERTEX_FLOATS;
+			const auto corner   = corners.data() + (quad * 4u + Renderer::QUAD_INDICES[i]) * VERTEX_FLOATS;
+			mismatched += !std::equal(triangle, triangle + VERTEX_FLOATS, corner);
+		}
+	CHECK(mismatched == 0u);
+
+	const auto megabytes = [](const std::size_t floats) { return std::to_string(static_cast<double>(floats * sizeof(float)) / (1024.0 * 1024.0)); };
+	Test::report(std::to_string(SPRITES) + " sprites: triangles " + std::to_string(trianglesMs) + " ms / " + megabytes(triangles.size()) + " MB, indexed " +
+				 std::to_string(cornersMs) + " ms / " + megabytes(corners.size()) + " MB");
+}
@@ -0,0 +1,107 @@
+#include "Test.h"
+
+#include "EntityRegistry.h"
+
+#include "Components/RectComponent.h"
+#include "Components/TransformComponent.h"
+
+TEST(viewScaling)
+{
+	for (const std::size_t entities : { 10000u, 100000u, 1000000u }) {
+		EntityRegistry registry;
+		std::vector<EntityHandle> handles;
+		handles.reserve(entities);
+
+		// Every entity moves, every other one is a sprite
+		for (std::size_t i = 0; i < entities; ++i) {
+			const auto handle = registry.create();
+			registry.addComponent<Component::Transform>(handle, static_cast<float>(i), 0.f, 64.f);
+			if (i % 2 == 0)
+				registry.addComponent<Component::Src>(handle, 0.f, 0.f, 64.f, 64.f);
+			handles.push_back(handle);
+		}
+
+		const auto count = [&registry]
+		{
+			std::size_t matched = 0;
+			registry.view<Component::Transform, Component::Src>().each([&matched](Component::Transform&, Component::Src& src) { matched += src.w > 0.f; });
+			return matched;
+		};
+
+		Test::Timer timer;
+		CHECK(count() == entities / 2);
+		const auto buildMs = timer.ms();
+
+		timer.reset();
+		CHECK(count() == entities / 2);
+		const auto iterateMs = timer.ms();
+
+		// What a system without views pays: visit every entity and look its components up
+		std::size_t scanned = 0;
+		timer.reset();
+		registry.each([&scanned](EntityHandle, Entity& entity)
+		{
+			if (entity.hasComponent<Component::Transform>() && entity.hasComponent<Component::Src>())
+				++scanned;
+		});
+		const auto scanMs = timer.ms();
+		CHECK(scanned == entities / 2);
+
+		// Incremental updates: removal and addition through the registry and straight through the entity, and destruction
+		timer.reset();
+		for (std::size_t i = 0; i < entities; i += 100) {
+			registry.removeComponent<Component::Src>(handles[i]);
+			registry.get(handles[i + 2])->removeComponent<Component::Src>();
+			registry.destroy(handles[i + 4]);
+			registry.addComponent<Component::Src>(handles[i + 1], 0.f, 0.f, 64.f, 64.f);
+			registry.get(handles[i + 3])->addComponent<Component::Src>(0.f, 0.f, 64.f, 64.f);
+		}
+		registry.flush();
+		const auto updateMs = timer.ms();
+
+		// Each block of 100 lost three sprites and gained two
+		CHECK(count() == entities / 2 - entities / 100);
+
+		Test::report(std::to_string(entities) + " entities: view built in " + std::to_string(buildMs) + " ms, iterated in " + std::to_string(iterateMs) +
+					 " ms (scan " + std::to_string(scanMs) + " ms), " + std::to_string(entities / 100 * 5) + " updates in " + std::to_string(updateMs) + " ms");
+	}
+}
+
+TEST(viewSeesComponentsAddedThroughEntity)
+{
+	EntityRegistry registry;
+	const auto sprites = [&registry] { return registry.view<Component::Transform, Component::Src>().size(); };
+
+	const auto added    = registry.create();
+	const auto keyed    = registry.create();
+	const auto recycled = registry.create();
+	for (const auto handle : { added, keyed, recycled })
+		registry.addComponent<Component::Transform>(handle, 0.f, 0.f, 64.f);
+	CHECK(sprites() == 0u);
+
+	// Srcs stored under their type's key straight through the entity, where getComponent<Src>() and so views look
+	registry.get(added)->addComponent<Component::Src>(0.f, 0.f, 64.f, 64.f);
+	registry.get(keyed)->addIDComponent<Component::Src>(getComponentTypeID<Component::Src>(), 0.f, 0.f, 64.f, 64.f);
+	CHECK(sprites() == 2u);
+
+	std::size_t matched = 0;
+	registry.view<Component::Transform, Component::Src>().each([&](const EntityHandle handle, Component::Transform&, Component::Src& src)
+	{
+		matched += src.w == 64.f && handle != recycled;
+	});
+	CHECK(matched == 2u);
+
+	// Destroyed entities stay out even if a component is added before the flush
+	const auto dead = registry.get(recycled);
+	registry.destroy(recycled);
+	dead->addComponent<Component::Src>(0.f, 0.f, 64.f, 64.f);
+	CHECK(sprites() == 2u);
+	registry.flush();
+
+	// The recycled slot starts empty and joins once it holds both
+	const auto reused = registry.create();
+	registry.get(reused)->addComponent<Component::Src>(0.f, 0.f, 64.f, 64.f);
+	CHECK(sprites() == 2u);
+	registry.get(reused)->addComponent<Component::Transform>(0.f, 0.f, 64.f);
+	CHECK(sprites() == 3u);
+}
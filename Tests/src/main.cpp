@@ -0,0 +1,84 @@
+#include "Test.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace
+{
+	std::size_t              failures = 0;
+	std::atomic<std::size_t> allocated{0};
+}
+
+// Counting replacements of the global allocation functions, the array and nothrow forms forward to these
+void* operator new(const std::size_t size)
+{
+	allocated.fetch_add(1u, std::memory_order_relaxed);
+	if (const auto block = std::malloc(size ? size : 1u))
+		return block;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept
+{
+	std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept
+{
+	std::free(block);
+}
+
+const void* volatile Test::sink = nullptr;
+
+std::vector<Test::Case>& Test::cases()
+{
+	// Function local so tests registered from any translation unit find it constructed
+	static std::vector<Case> registered;
+	return registered;
+}
+
+void Test::fail(const char* expression, const char* file, const int line)
+{
+	++failures;
+	std::cerr << "\tFAILED: " << expression << " (" << file << ":" << line << ")\n";
+}
+
+void Test::report(const std::string& line)
+{
+	std::cout << "\t" << line << "\n";
+}
+
+std::size_t Test::allocations()
+{
+	return allocated.load(std::memory_order_relaxed);
+}
+
+// Runs every test, or only the ones whose name contains the first argument, and returns the number of failed checks
+int main(const int argc, char* argv[])
+{
+	const auto filter = argc > 1 ? argv[1] : "";
+
+	std::size_t ran = 0, failed = 0;
+	for (const auto& test : Test::cases()) {
+		if (!std::strstr(test.name, filter))
+			continue;
+
+		std::cout << "[ RUN  ] " << test.name << "\n";
+		const auto before = failures;
+		test.function();
+		++ran;
+
+		if (failures == before)
+			std::cout << "[  OK  ] " << test.name << "\n";
+		else {
+			std::cout << "[ FAIL ] " << test.name << "\n";
+			++failed;
+		}
+	}
+
+	std::cout << ran - failed << "/" << ran << " tests passed\n";
+	return static_cast<int>(failures);
+}
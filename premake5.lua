@@ -116,6 +116,134 @@ project "Engine"
 		runtime "Release"
 		optimize "on"
 
+project "Headless"
+	location "Headless"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- The engine's --headless mode on its own: no window, GLFW, glad or renderer, so it builds and runs on machines without a GPU
+	files
+	{
+		"Engine/src/**.h",
+		"Engine/src/**.cpp"
+	}
+
+	removefiles
+	{
+		"Engine/src/DelimiterSplit.*",
+		"Engine/src/RenderQueue.*",
+		"Engine/src/Components/MaterialComponent.*",
+		"Engine/src/Components/RendererComponent.*",
+		"Engine/src/Components/ShaderComponent.*",
+		"Engine/src/Components/TextureComponent.*",
+		"Engine/src/Systems/RenderSystem.h"
+	}
+
+	defines
+	{
+		"_CRT_SECURE_NO_WARNINGS",
+		"HEADLESS_ONLY"
+	}
+
+	includedirs
+	{
+		"Engine/src",
+		"%{IncludeDir.glm}"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+	filter "system:linux"
+		links
+		{
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		runtime "Release"
+		optimize "on"
+
+project "Tests"
+	location "Tests"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- Checks and benchmarks for the engine, built like Headless so they run without a GPU. Run the Release build for benchmark figures,
+	-- pass part of a test name to run only the matching tests. Exits with the number of failed checks
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"Engine/src/**.h",
+		"Engine/src/**.cpp"
+	}
+
+	removefiles
+	{
+		"Engine/src/main.cpp",
+		"Engine/src/DelimiterSplit.*",
+		"Engine/src/RenderQueue.cpp",
+		"Engine/src/Components/MaterialComponent.cpp",
+		"Engine/src/Components/RendererComponent.cpp",
+		"Engine/src/Components/ShaderComponent.cpp",
+		"Engine/src/Components/TextureComponent.cpp"
+	}
+
+	defines
+	{
+		"_CRT_SECURE_NO_WARNINGS",
+		"HEADLESS_ONLY"
+	}
+
+	-- Glad's headers only, for the CPU side of the renderer, nothing that calls OpenGL is compiled in
+	includedirs
+	{
+		"%{prj.name}/src",
+		"Engine/src",
+		"%{IncludeDir.Glad}",
+		"%{IncludeDir.glm}"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+	filter "system:linux"
+		links
+		{
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		runtime "Release"
+		optimize "on"
+
 project "RPG"
 	location "RPG"
 	kind "ConsoleApp"